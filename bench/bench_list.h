@@ -0,0 +1,33 @@
+/*******************************************************************************
+* FILE NAME: bench_list.h
+*
+* DESCRIPTION:
+*  The benchmarks run by bench_main.c, in the order their results are stored.
+*  report.sh reads this file for the names, so keep one X(name) per line.
+*  Names starting with tick_ are whole 17ms ticks and are also checked
+*  against the cycle budget.
+*
+*******************************************************************************/
+
+#ifndef __bench_list_h_
+#define __bench_list_h_
+
+#define BENCH_LIST(X) \
+  X(limit_mix) \
+  X(set_lb_motor) \
+  X(set_all_motors) \
+  X(light_sensors) \
+  X(prox_sensors) \
+  X(camera_pixel) \
+  X(slew_limit) \
+  X(drive_profile) \
+  X(param_service_idle) \
+  X(tick_joystick) \
+  X(tick_light_follow) \
+  X(tick_wall_climb)
+
+#define BENCH_ENUM(name)   B_##name,
+enum { BENCH_LIST(BENCH_ENUM) NUM_BENCH };
+#undef BENCH_ENUM
+
+#endif
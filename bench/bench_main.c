@@ -0,0 +1,198 @@
+/*******************************************************************************
+* FILE NAME: bench_main.c
+*
+* DESCRIPTION:
+*  Cycle-count benchmarks for the hot paths in user_routines.c, built for the
+*  PIC18 with SDCC and run under gpsim (see the Makefile).
+*
+*  Each benchmark runs between a start and stop of Timer1 at 1:1 from the
+*  instruction clock, so the count is exact.  The cost of starting and
+*  stopping the timer is measured once and taken off every result.  A count
+*  that overflows 16 bits is stored as 0xFFFF; at 10MHz that is already more
+*  than a whole 17ms tick.
+*
+*  Results are left in RAM behind the "BNCH" marker, and gpsim dumps RAM
+*  when it hits Bench_Done.  report.sh finds the marker and decodes them.
+*
+*******************************************************************************/
+
+#include "ifi_aliases.h"
+#include "ifi_default.h"
+#include "ifi_utilities.h"
+#include "user_routines.h"
+#include "../param_table.h"
+#include "bench_list.h"
+
+struct bench_results {
+  unsigned char magic[4];
+  unsigned char count;
+  unsigned int cycles[NUM_BENCH];
+};
+
+struct bench_results results;
+unsigned int overhead = 0;
+
+/* volatile so the compiler can't fold the inputs or drop the calls */
+volatile int in_mix = 2100;
+volatile float in_motor = 0.6;
+volatile int in_light = 400;
+volatile int in_prox = 120;
+volatile unsigned char sink_uc;
+volatile float sink_f;
+volatile int sink_i;
+
+extern unsigned int auto_mode, counter, drive_state;
+extern float Left_Side, Right_Side;
+extern int left_profile, right_profile;
+
+#define TIMER_START() \
+  TMR1H = 0; TMR1L = 0; PIR1bits.TMR1IF = 0; T1CONbits.TMR1ON = 1
+
+#define TIMER_STOP() \
+  T1CONbits.TMR1ON = 0
+
+
+static unsigned int Timer_Read(void)
+{
+  unsigned char lo, hi;
+
+  if (PIR1bits.TMR1IF)
+    return 0xFFFF;
+  lo = TMR1L;             /* reading TMR1L latches TMR1H in 16 bit mode */
+  hi = TMR1H;
+  return ((unsigned int)hi << 8) | lo;
+}
+
+
+static void Record(unsigned char id)
+{
+  unsigned int t = Timer_Read();
+
+  if (t != 0xFFFF)
+    t = t - overhead;
+  results.cycles[id] = t;
+}
+
+
+// sets the simulated analog inputs and radio for one tick
+static void Set_Inputs(int left_light, int right_light, int left_prox,
+                       int middle_prox, int right_prox)
+{
+  bench_analog[rc_ana_in02] = left_light;
+  bench_analog[rc_ana_in01] = right_light;
+  bench_analog[rc_ana_in06] = left_prox;
+  bench_analog[rc_ana_in07] = middle_prox;
+  bench_analog[rc_ana_in05] = right_prox;
+  bench_analog[rc_ana_in04] = 800;       /* arm off both limit switches */
+  bench_analog[rc_ana_in03] = 200;
+  bench_analog[rc_ana_in08] = 512;
+  PWM_in1 = 180;                         /* some stick, buttons released */
+  PWM_in2 = 160;
+  PWM_in3 = 127;
+  PWM_in4 = 127;                         /* e-stop stick centred */
+  PWM_in5 = 127;
+  PWM_in6 = 127;
+}
+
+
+/* gpsim stops here; the Makefile's script dumps RAM and quits */
+void Bench_Done(void)
+{
+  while (1)
+    ;
+}
+
+
+void main(void)
+{
+  Bench_Initialization();
+  Param_Initialization();
+  T1CON = 0x80;           /* 16 bit reads, 1:1, instruction clock, stopped */
+
+  TIMER_START();
+  TIMER_STOP();
+  overhead = Timer_Read();
+
+  TIMER_START();
+  sink_uc = Limit_Mix(in_mix);
+  TIMER_STOP();
+  Record(B_limit_mix);
+
+  TIMER_START();
+  sink_uc = Set_LB_Motor(in_motor);
+  TIMER_STOP();
+  Record(B_set_lb_motor);
+
+  TIMER_START();
+  sink_uc = Set_LB_Motor(in_motor);
+  sink_uc = Set_RB_Motor(in_motor);
+  sink_uc = Set_LF_Motor(in_motor);
+  sink_uc = Set_RF_Motor(in_motor);
+  TIMER_STOP();
+  Record(B_set_all_motors);
+
+  TIMER_START();
+  sink_f = Set_L_Light_Sensor(in_light) - Set_R_Light_Sensor(in_light);
+  TIMER_STOP();
+  Record(B_light_sensors);
+
+  TIMER_START();
+  sink_f = Set_L_Prox(in_prox) - Set_R_Prox(in_prox);
+  TIMER_STOP();
+  Record(B_prox_sensors);
+
+  TIMER_START();
+  sink_i = Read_Camera_Pixel();
+  TIMER_STOP();
+  Record(B_camera_pixel);
+
+  TIMER_START();
+  sink_i = Slew_Limit(200, -600, 48, 96);
+  TIMER_STOP();
+  Record(B_slew_limit);
+
+  Left_Side = 0.8;
+  Right_Side = 0.8;
+  left_profile = right_profile = 0;
+  auto_mode = 5;
+  TIMER_START();
+  Drive_Profile(0);
+  TIMER_STOP();
+  Record(B_drive_profile);
+
+  TIMER_START();
+  Param_Service();
+  TIMER_STOP();
+  Record(B_param_service_idle);
+
+  Set_Inputs(500, 500, 100, 60, 100);
+  auto_mode = 0;
+  counter = 0;
+  TIMER_START();
+  Process_Data_From_Master_uP();
+  TIMER_STOP();
+  Record(B_tick_joystick);
+
+  Set_Inputs(600, 400, 100, 60, 100);
+  auto_mode = 1;
+  counter = 0;
+  TIMER_START();
+  Process_Data_From_Master_uP();
+  TIMER_STOP();
+  Record(B_tick_light_follow);
+
+  Set_Inputs(500, 500, 10, 300, 10);
+  auto_mode = 5;
+  counter = 0;
+  TIMER_START();
+  Process_Data_From_Master_uP();
+  TIMER_STOP();
+  Record(B_tick_wall_climb);
+
+  results.magic[0] = 'B';
+  results.magic[1] = 'N';
+  results.magic[2] = 'C';
+  results.magic[3] = 'H';
+  results.count = NUM_BENCH;
+  Bench_Done();
+}
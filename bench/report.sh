@@ -0,0 +1,152 @@
+#!/bin/sh
+#
+# report.sh - decode the benchmark results from a gpsim RAM dump
+#
+# usage: report.sh [-c] [-u] [-b baseline] [-t tolerance_pct] [-f fosc_hz] dump
+#
+#   -c   compare with the baseline and exit 1 if anything got slower by more
+#        than the tolerance, has no baseline yet, or a tick_ benchmark is
+#        over the 17ms budget
+#   -u   write the current counts to the baseline
+#
+# The names come from bench_list.h, in the same order bench_main.c stores
+# the results behind the "BNCH" marker.
+
+dir=$(dirname "$0")
+baseline="$dir/baseline.txt"
+check=0
+update=0
+tolerance=0
+fosc=10000000
+
+while getopts "cub:t:f:" opt; do
+  case $opt in
+    c) check=1 ;;
+    u) update=1 ;;
+    b) baseline=$OPTARG ;;
+    t) tolerance=$OPTARG ;;
+    f) fosc=$OPTARG ;;
+    *) sed -n '5p' "$0" >&2; exit 2 ;;
+  esac
+done
+shift $((OPTIND - 1))
+if [ $# -ne 1 ]; then
+  sed -n '5p' "$0" >&2
+  exit 2
+fi
+dump=$1
+
+[ -f "$baseline" ] || : > "$baseline"
+new_baseline="$baseline.new"
+
+awk -v check="$check" -v tolerance="$tolerance" -v fosc="$fosc" \
+    -v new_baseline="$new_baseline" '
+function hex(s,    i, c, v) {
+  v = 0
+  s = tolower(s)
+  for (i = 1; i <= length(s); i++) {
+    c = index("0123456789abcdef", substr(s, i, 1))
+    if (c == 0) return -1
+    v = v * 16 + c - 1
+  }
+  return v
+}
+
+FILENAME == ARGV[1] {                    # bench_list.h
+  if (match($0, /^[ \t]*X\([a-z_0-9]+\)/)) {
+    name = substr($0, RSTART, RLENGTH)
+    sub(/^[ \t]*X\(/, "", name)
+    sub(/\)$/, "", name)
+    names[nnames++] = name
+  }
+  next
+}
+
+FILENAME == ARGV[2] {                    # baseline.txt
+  if ($0 !~ /^#/ && NF >= 2)
+    base[$1] = $2
+  next
+}
+
+# gpsim dump rows: "addr: xx xx ... (16 values) ascii".  "--" marks an
+# unimplemented register.  The ASCII column can hold things that look like
+# hex, so only 16 values are read.  RAM comes first; the EEPROM that may
+# follow starts again at 000, so stop at the first address that goes back.
+done_ram == 0 && $1 ~ /^[0-9A-Fa-f]+:$/ {
+  addr = hex(substr($1, 1, length($1) - 1))
+  if (seen && addr <= last) {
+    done_ram = 1
+    next
+  }
+  seen = 1
+  last = addr
+  for (i = 2; i <= 17 && i <= NF; i++) {
+    if ($i == "--")
+      continue
+    if ($i !~ /^[0-9A-Fa-f][0-9A-Fa-f]$/)
+      break
+    ram[addr + i - 2] = hex($i)
+    if (addr + i - 2 > top) top = addr + i - 2
+  }
+}
+
+END {
+  budget = int(0.017 * fosc / 4)
+  for (a = 0; a <= top; a++)
+    if (ram[a] == 66 && ram[a + 1] == 78 && ram[a + 2] == 67 && ram[a + 3] == 72)
+      break
+  if (a > top) {
+    print "report.sh: no BNCH results in the dump (did the run reach Bench_Done?)" > "/dev/stderr"
+    exit 2
+  }
+  if (ram[a + 4] != nnames) {
+    printf "report.sh: dump has %d results, bench_list.h has %d\n", ram[a + 4], nnames > "/dev/stderr"
+    exit 2
+  }
+
+  printf "%-20s %8s %10s %8s %10s\n", "benchmark", "cycles", "us", "budget", "baseline"
+  bad = 0
+  print "# benchmark cycles (Fosc " fosc " Hz)" > new_baseline
+  for (i = 0; i < nnames; i++) {
+    n = names[i]
+    c = ram[a + 5 + 2 * i] + 256 * ram[a + 6 + 2 * i]
+    print n, c > new_baseline
+    note = ""
+    if (c == 65535) note = "  OVERFLOW"
+    if (n in base) {
+      delta = sprintf("%+d", c - base[n])
+      if (c > base[n] * (1 + tolerance / 100)) {
+        note = note "  SLOWER"
+        if (check) bad = 1
+      }
+    }
+    else {
+      delta = "new"
+      if (check) {
+        note = note "  NO BASELINE"
+        bad = 1
+      }
+    }
+    if (n ~ /^tick_/ && c >= budget) {
+      note = note "  OVER BUDGET"
+      if (check) bad = 1
+    }
+    printf "%-20s %8d %10.1f %7.1f%% %10s%s\n", n, c, c * 4e6 / fosc,
+           100 * c / budget, delta, note
+  }
+  close(new_baseline)
+  printf "17ms budget = %d cycles at %d Hz\n", budget, fosc
+  if (check && bad)
+    print "report.sh: check failed (run make baseline to record missing entries)" > "/dev/stderr"
+  exit bad
+}
+' "$dir/bench_list.h" "$baseline" "$dump"
+status=$?
+
+if [ $status -le 1 ] && [ $update -eq 1 ]; then
+  mv "$new_baseline" "$baseline"
+  echo "baseline written to $baseline"
+else
+  rm -f "$new_baseline"
+fi
+exit $status
@@ -0,0 +1,71 @@
+/*******************************************************************************
+* FILE NAME: ifi_aliases.h <BENCH STUB>
+*
+* DESCRIPTION:
+*  Pin and PWM names used by user_routines.c, mapped onto plain RAM and port
+*  latches so the benchmarks build with SDCC.  The camera clock and SI pins
+*  are real LAT bits so their bsf/bcf cost the same as on the robot.
+*
+*******************************************************************************/
+
+#ifndef __ifi_aliases_h_
+#define __ifi_aliases_h_
+
+#include "ifi_default.h"
+
+#define INPUT           1
+#define OUTPUT          0
+#define USER            0
+#define MASTER          1
+#define IFI_PWM         0
+#define USER_CCP        1
+#define THREE_ANALOG    0x0C
+
+#define pwm01           txdata.rc_pwm01
+#define pwm02           txdata.rc_pwm02
+#define pwm03           txdata.rc_pwm03
+#define pwm04           txdata.rc_pwm04
+#define pwm05           txdata.rc_pwm05
+#define pwm06           txdata.rc_pwm06
+#define pwm07           txdata.rc_pwm07
+#define pwm08           txdata.rc_pwm08
+
+#define PWM_in1         rxdata.oi_analog01
+#define PWM_in2         rxdata.oi_analog02
+#define PWM_in3         rxdata.oi_analog03
+#define PWM_in4         rxdata.oi_analog04
+#define PWM_in5         rxdata.oi_analog05
+#define PWM_in6         rxdata.oi_analog06
+
+/* analog channel numbers index bench_analog[] (ifi_utilities.h) */
+#define rc_ana_in01     1
+#define rc_ana_in02     2
+#define rc_ana_in03     3
+#define rc_ana_in04     4
+#define rc_ana_in05     5
+#define rc_ana_in06     6
+#define rc_ana_in07     7
+#define rc_ana_in08     8
+
+#define rc_dig_out14    LATDbits.LATD0
+#define rc_dig_out16    LATDbits.LATD1
+
+extern unsigned char bench_io[17];
+#define IO1             bench_io[1]
+#define IO2             bench_io[2]
+#define IO3             bench_io[3]
+#define IO4             bench_io[4]
+#define IO5             bench_io[5]
+#define IO6             bench_io[6]
+#define IO7             bench_io[7]
+#define IO8             bench_io[8]
+#define IO9             bench_io[9]
+#define IO10            bench_io[10]
+#define IO11            bench_io[11]
+#define IO12            bench_io[12]
+#define IO13            bench_io[13]
+#define IO14            bench_io[14]
+#define IO15            bench_io[15]
+#define IO16            bench_io[16]
+
+#endif
@@ -0,0 +1,42 @@
+/*******************************************************************************
+* FILE NAME: ifi_default.h <BENCH STUB>
+*
+* DESCRIPTION:
+*  Just enough of the IFI default code's data records for user_routines.c to
+*  build with SDCC for the benchmarks.  Not for the robot.
+*
+*******************************************************************************/
+
+#ifndef __ifi_default_h_
+#define __ifi_default_h_
+
+#include <pic18fregs.h>
+
+#define rom     __code        /* MPLAB C18 program memory qualifier */
+
+typedef struct {
+  unsigned char master_version;
+  unsigned char oi_analog01, oi_analog02, oi_analog03;
+  unsigned char oi_analog04, oi_analog05, oi_analog06;
+} rx_data_record;
+
+typedef struct {
+  unsigned char pwm_mask;
+  unsigned char rc_pwm01, rc_pwm02, rc_pwm03, rc_pwm04;
+  unsigned char rc_pwm05, rc_pwm06, rc_pwm07, rc_pwm08;
+} tx_data_record;
+
+typedef struct {
+  unsigned NEW_SPI_DATA:1;
+  unsigned :7;
+} packed_struct;
+
+extern rx_data_record rxdata;
+extern tx_data_record txdata;
+extern packed_struct statusflag;
+
+void Getdata(rx_data_record *ptr);
+void Putdata(tx_data_record *ptr);
+void User_Proc_Is_Ready(void);
+
+#endif
@@ -0,0 +1,74 @@
+/*******************************************************************************
+* FILE NAME: ifi_stubs.c <BENCH STUB>
+*
+* DESCRIPTION:
+*  Stand-ins for the IFI library so user_routines.c links for the
+*  benchmarks.  Get_Analog_Value only returns bench_analog[], so every run
+*  takes the same branches.  It does no A/D conversion: the IFI library's
+*  conversion time is not in the counts, and each tick_ result leaves out
+*  its eight Get_Analog_Value conversions.
+*
+*******************************************************************************/
+
+#include "ifi_aliases.h"
+#include "ifi_default.h"
+#include "ifi_utilities.h"
+
+rx_data_record rxdata;
+tx_data_record txdata;
+packed_struct statusflag;
+unsigned char bench_io[17];
+int bench_analog[17];
+
+
+void Bench_Initialization(void)
+{
+  TRISD = 0xFC;            /* camera clock and SI (rc_dig_out14/16) */
+  LATD = 0;
+  rxdata.master_version = 1;
+}
+
+
+unsigned int Get_Analog_Value(unsigned char channel)
+{
+  return (unsigned int)bench_analog[channel];
+}
+
+
+void Getdata(rx_data_record *ptr)
+{
+  (void)ptr;
+}
+
+
+void Putdata(tx_data_record *ptr)
+{
+  (void)ptr;
+}
+
+
+void User_Proc_Is_Ready(void)
+{
+}
+
+
+void Set_Number_of_Analog_Channels(unsigned char number_of_channels)
+{
+  (void)number_of_channels;
+}
+
+
+void Initialize_Serial_Comms(void)
+{
+  TXSTA = 0x24;            /* transmit enabled, high speed */
+  RCSTA = 0x90;            /* serial port and receiver enabled */
+}
+
+
+void Setup_PWM_Output_Type(int pwmSpec1, int pwmSpec2, int pwmSpec3, int pwmSpec4)
+{
+  (void)pwmSpec1;
+  (void)pwmSpec2;
+  (void)pwmSpec3;
+  (void)pwmSpec4;
+}
@@ -0,0 +1,23 @@
+/*******************************************************************************
+* FILE NAME: ifi_utilities.h <BENCH STUB>
+*
+* DESCRIPTION:
+*  IFI library calls used by user_routines.c, plus the hooks bench_main.c
+*  uses to set up the simulated inputs.
+*
+*******************************************************************************/
+
+#ifndef __ifi_utilities_h_
+#define __ifi_utilities_h_
+
+/* value Get_Analog_Value returns for each rc_ana_inXX channel */
+extern int bench_analog[17];
+
+void Bench_Initialization(void);
+
+unsigned int Get_Analog_Value(unsigned char channel);
+void Set_Number_of_Analog_Channels(unsigned char number_of_channels);
+void Initialize_Serial_Comms(void);
+void Setup_PWM_Output_Type(int pwmSpec1, int pwmSpec2, int pwmSpec3, int pwmSpec4);
+
+#endif
@@ -0,0 +1,14 @@
+/*******************************************************************************
+* FILE NAME: printf_lib.h <BENCH STUB>
+*
+* DESCRIPTION:
+*  The IFI printf library is replaced by SDCC's own.
+*
+*******************************************************************************/
+
+#ifndef __printf_lib_h_
+#define __printf_lib_h_
+
+#include <stdio.h>
+
+#endif
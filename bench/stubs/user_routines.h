@@ -0,0 +1,30 @@
+/*******************************************************************************
+* FILE NAME: user_routines.h <BENCH STUB>
+*
+* DESCRIPTION:
+*  Prototypes for the functions in user_routines.c.
+*
+*******************************************************************************/
+
+#ifndef __user_routines_h_
+#define __user_routines_h_
+
+void User_Initialization(void);
+void Process_Data_From_Master_uP(void);
+void Default_Routine(void);
+
+unsigned char Limit_Mix(int intermediate_value);
+unsigned char Set_LB_Motor(float motor_val);
+unsigned char Set_RB_Motor(float motor_val);
+unsigned char Set_LF_Motor(float motor_val);
+unsigned char Set_RF_Motor(float motor_val);
+float Set_L_Light_Sensor(int left_eye);
+float Set_R_Light_Sensor(int right_eye);
+float Set_L_Prox(int left_prox);
+float Set_R_Prox(int right_prox);
+void Process_Driving_State(int drive_state);
+int Read_Camera_Pixel(void);
+int Slew_Limit(int current, int target, int accel, int decel);
+void Drive_Profile(int estop);
+
+#endif
@@ -0,0 +1,244 @@
+/*******************************************************************************
+* FILE NAME: coltable.c
+*
+* DESCRIPTION:
+*  Column-oriented session file.  See coltable.h for the layout.
+*
+*  The writer keeps the current chunk in memory and writes it in place with
+*  pwrite on every flush, so a reader (or a crash) sees at most one flush
+*  interval less than what was received.
+*
+*******************************************************************************/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "coltable.h"
+
+#define PAGE_ROUND(n)   (((n) + 4095) & ~(uint64_t)4095)
+
+
+void Table_Init(struct table_writer *w)
+{
+  memset(w, 0, sizeof(*w));
+  w->fd = -1;
+  memcpy(w->h.magic, COLTABLE_MAGIC, sizeof(w->h.magic));
+  w->h.header_bytes = COLTABLE_HEADER_BYTES;
+  w->h.chunk_rows = COLTABLE_CHUNK_ROWS;
+}
+
+
+int Table_Add_Column(struct table_writer *w, const char *name, int elem_bytes, int count)
+{
+  struct col_desc *c;
+
+  if (w->fd >= 0 || w->h.ncols >= COLTABLE_MAX_COLS || count <= 0 ||
+      (elem_bytes != 1 && elem_bytes != 2 && elem_bytes != 4 && elem_bytes != 8)) {
+    errno = EINVAL;
+    return -1;
+  }
+
+  c = &w->h.cols[w->h.ncols];
+  strncpy(c->name, name, sizeof(c->name) - 1);
+  c->elem_bytes = (uint16_t)elem_bytes;
+  c->count = (uint16_t)count;
+  c->width = (uint32_t)(elem_bytes * count);
+  c->offset = w->h.chunk_bytes;
+  w->h.chunk_bytes += ((uint64_t)c->width * w->h.chunk_rows + 7) & ~(uint64_t)7;
+  return (int)w->h.ncols++;
+}
+
+
+int Table_Create_File(struct table_writer *w, const char *path, uint64_t start_unix_us)
+{
+  unsigned char header[COLTABLE_HEADER_BYTES];
+
+  w->h.chunk_bytes = PAGE_ROUND(w->h.chunk_bytes);
+  w->h.start_unix_us = start_unix_us;
+  w->chunk = calloc(1, w->h.chunk_bytes);
+  if (w->chunk == NULL)
+    return -1;
+
+  w->fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (w->fd < 0)
+    return -1;
+
+  memset(header, 0, sizeof(header));
+  memcpy(header, &w->h, sizeof(w->h));
+  if (pwrite(w->fd, header, sizeof(header), 0) != (ssize_t)sizeof(header))
+    return -1;
+  return 0;
+}
+
+
+void *Table_Cell(struct table_writer *w, int col)
+{
+  const struct col_desc *c = &w->h.cols[col];
+  uint64_t r = w->h.rows - w->chunk_first_row;
+
+  return w->chunk + c->offset + r * c->width;
+}
+
+
+int Table_Next_Row(struct table_writer *w)
+{
+  w->h.rows++;
+  if (w->h.rows - w->chunk_first_row < w->h.chunk_rows)
+    return 0;
+
+  /* chunk full: write it out and start the next one */
+  if (Table_Flush(w) < 0)
+    return -1;
+  w->chunk_first_row = w->h.rows;
+  memset(w->chunk, 0, w->h.chunk_bytes);
+  return 0;
+}
+
+
+int Table_Flush(struct table_writer *w)
+{
+  off_t ofs = (off_t)(w->h.header_bytes +
+                      (w->chunk_first_row / w->h.chunk_rows) * w->h.chunk_bytes);
+
+  if (w->h.rows > w->chunk_first_row &&
+      pwrite(w->fd, w->chunk, w->h.chunk_bytes, ofs) != (ssize_t)w->h.chunk_bytes)
+    return -1;
+
+  /* the row count goes last so readers never see rows that aren't there */
+  if (pwrite(w->fd, &w->h, sizeof(w->h), 0) != (ssize_t)sizeof(w->h))
+    return -1;
+  return 0;
+}
+
+
+int Table_Close(struct table_writer *w)
+{
+  int err = 0;
+
+  if (w->fd >= 0) {
+    err = Table_Flush(w);
+    if (close(w->fd) < 0)
+      err = -1;
+  }
+  free(w->chunk);
+  w->chunk = NULL;
+  w->fd = -1;
+  return err;
+}
+
+
+/*
+ *  Checks everything Table_At does arithmetic with, so a corrupt or
+ *  truncated file is rejected here instead of faulting on a later read.
+ */
+static int Header_Valid(const struct table_header *h, size_t size)
+{
+  const struct col_desc *c;
+  uint64_t chunks;
+  uint32_t i;
+
+  if (memcmp(h->magic, COLTABLE_MAGIC, sizeof(h->magic)) != 0 ||
+      h->header_bytes < sizeof(*h) || h->header_bytes > size ||
+      h->ncols > COLTABLE_MAX_COLS || h->chunk_rows == 0 || h->chunk_bytes == 0)
+    return 0;
+
+  for (i = 0; i < h->ncols; i++) {
+    c = &h->cols[i];
+    if ((c->elem_bytes != 1 && c->elem_bytes != 2 && c->elem_bytes != 4 && c->elem_bytes != 8) ||
+        c->count == 0 || c->width != (uint32_t)c->elem_bytes * c->count)
+      return 0;
+    /* offset + width * chunk_rows <= chunk_bytes, without overflowing */
+    if (c->offset > h->chunk_bytes ||
+        c->width > (h->chunk_bytes - c->offset) / h->chunk_rows)
+      return 0;
+  }
+
+  chunks = h->rows / h->chunk_rows + (h->rows % h->chunk_rows != 0);
+  return chunks <= (size - h->header_bytes) / h->chunk_bytes;
+}
+
+
+int Table_Map(struct table_map *m, const char *path)
+{
+  struct stat st;
+
+  memset(m, 0, sizeof(*m));
+  m->fd = open(path, O_RDONLY);
+  if (m->fd < 0)
+    return -1;
+  if (fstat(m->fd, &st) < 0 || (size_t)st.st_size < COLTABLE_HEADER_BYTES) {
+    close(m->fd);
+    errno = EINVAL;
+    return -1;
+  }
+
+  m->size = (size_t)st.st_size;
+  m->base = mmap(NULL, m->size, PROT_READ, MAP_SHARED, m->fd, 0);
+  if (m->base == MAP_FAILED) {
+    close(m->fd);
+    return -1;
+  }
+  m->h = (const struct table_header *)m->base;
+
+  if (!Header_Valid(m->h, m->size)) {
+    Table_Unmap(m);
+    errno = EINVAL;
+    return -1;
+  }
+  m->rows = m->h->rows;        /* a live recording keeps growing past the mapping */
+  return 0;
+}
+
+
+void Table_Unmap(struct table_map *m)
+{
+  if (m->base != NULL && m->base != MAP_FAILED)
+    munmap((void *)m->base, m->size);
+  if (m->fd >= 0)
+    close(m->fd);
+  memset(m, 0, sizeof(*m));
+  m->fd = -1;
+}
+
+
+int Table_Find_Column(const struct table_map *m, const char *name)
+{
+  uint32_t i;
+
+  for (i = 0; i < m->h->ncols; i++) {
+    if (strncmp(m->h->cols[i].name, name, COLTABLE_NAME_LEN) == 0)
+      return (int)i;
+  }
+  return -1;
+}
+
+
+const void *Table_At(const struct table_map *m, int col, uint64_t row)
+{
+  const struct col_desc *c = &m->h->cols[col];
+
+  return m->base + m->h->header_bytes +
+         (row / m->h->chunk_rows) * m->h->chunk_bytes +
+         c->offset + (row % m->h->chunk_rows) * c->width;
+}
+
+
+uint64_t Table_Lower_Bound(const struct table_map *m, int col, uint64_t value)
+{
+  uint64_t lo = 0, hi = m->rows, mid, v;
+
+  while (lo < hi) {
+    mid = lo + (hi - lo) / 2;
+    memcpy(&v, Table_At(m, col, mid), sizeof(v));
+    if (v < value)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
@@ -0,0 +1,85 @@
+/*******************************************************************************
+* FILE NAME: coltable.h
+*
+* DESCRIPTION:
+*  Column-oriented session file for recorded telemetry.
+*
+*  The file is a 4KB header followed by fixed-size chunks.  Each chunk holds
+*  chunk_rows rows stored column by column, so one channel over time is a
+*  contiguous run and any row is found with arithmetic alone:
+*
+*    cell = header_bytes + (row / chunk_rows) * chunk_bytes
+*           + col.offset + (row % chunk_rows) * col.width
+*
+*  Readers mmap the file and only touch the pages they look at, which keeps
+*  seeking in an hour-long session cheap.  Values are stored in the host's
+*  byte order, so a session is read back on the same kind of machine.
+*
+*******************************************************************************/
+
+#ifndef __coltable_h_
+#define __coltable_h_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define COLTABLE_MAGIC          "VEXCOLT1"
+#define COLTABLE_HEADER_BYTES   4096
+#define COLTABLE_CHUNK_ROWS     256
+#define COLTABLE_MAX_COLS       32
+#define COLTABLE_NAME_LEN       24
+
+struct col_desc {
+  char name[COLTABLE_NAME_LEN];
+  uint16_t elem_bytes;         /* 1, 2, 4 or 8 */
+  uint16_t count;              /* elements per row, e.g. 128 pixels */
+  uint32_t width;              /* elem_bytes * count */
+  uint64_t offset;             /* from the start of a chunk */
+};
+
+struct table_header {
+  char magic[8];
+  uint32_t header_bytes;
+  uint32_t chunk_rows;
+  uint64_t chunk_bytes;
+  uint64_t rows;               /* rows written so far, updated on flush */
+  uint64_t start_unix_us;      /* wall clock time of row t = 0 */
+  uint32_t ncols;
+  uint32_t reserved;
+  struct col_desc cols[COLTABLE_MAX_COLS];
+};
+
+struct table_writer {
+  int fd;
+  struct table_header h;
+  unsigned char *chunk;        /* the chunk being filled */
+  uint64_t chunk_first_row;
+};
+
+struct table_map {
+  int fd;
+  const unsigned char *base;
+  size_t size;
+  const struct table_header *h;
+  uint64_t rows;               /* rows that were in the file when it was mapped */
+};
+
+/* Writer.  Columns are added before the first Table_Create_File call. */
+void Table_Init(struct table_writer *w);
+int Table_Add_Column(struct table_writer *w, const char *name, int elem_bytes, int count);
+int Table_Create_File(struct table_writer *w, const char *path, uint64_t start_unix_us);
+void *Table_Cell(struct table_writer *w, int col);   /* cell in the row being built */
+int Table_Next_Row(struct table_writer *w);
+int Table_Flush(struct table_writer *w);
+int Table_Close(struct table_writer *w);
+
+/* Reader. */
+int Table_Map(struct table_map *m, const char *path);
+void Table_Unmap(struct table_map *m);
+int Table_Find_Column(const struct table_map *m, const char *name);
+const void *Table_At(const struct table_map *m, int col, uint64_t row);
+
+/* First row whose uint64 column value is >= value (column must be sorted). */
+uint64_t Table_Lower_Bound(const struct table_map *m, int col, uint64_t value);
+
+#endif
@@ -0,0 +1,106 @@
+/*******************************************************************************
+* FILE NAME: frame_parser.c
+*
+* DESCRIPTION:
+*  Incremental parser for the robot's serial stream.  See frame_parser.h.
+*
+*  A reply frame is PARAM_REPLY_SYNC, cmd, len, payload, checksum.  The sync
+*  byte is 0x5A, which is ASCII 'Z', so it can turn up in printed text; a
+*  false sync fails the length or checksum test, is treated as ASCII and the
+*  scan moves on by one byte.  In the ASCII, every run of digits is one
+*  number; 129 of them in a row make one camera line-scan and a newline
+*  throws away a partial one.  A frame ends any number in progress, so digits
+*  on either side of a frame are never joined.
+*
+*******************************************************************************/
+
+#include <string.h>
+
+#include "../param_table.h"
+#include "frame_parser.h"
+
+void Parser_Init(struct frame_parser *p, frame_fn on_frame, camera_fn on_camera, void *ctx)
+{
+  memset(p, 0, sizeof(*p));
+  p->on_frame = on_frame;
+  p->on_camera = on_camera;
+  p->ctx = ctx;
+}
+
+
+unsigned char *Parser_Space(struct frame_parser *p, size_t *room)
+{
+  *room = sizeof(p->buf) - p->len;
+  return p->buf + p->len;
+}
+
+
+static void Ascii_Byte(struct frame_parser *p, unsigned char c)
+{
+  if (c >= '0' && c <= '9') {
+    p->number = p->number * 10 + (uint32_t)(c - '0');
+    p->in_number = 1;
+    return;
+  }
+
+  if (p->in_number) {
+    p->cam[p->cam_count++] = (uint16_t)(p->number > 0xFFFF ? 0xFFFF : p->number);
+    p->number = 0;
+    p->in_number = 0;
+    if (p->cam_count == TLM_CAM_VALUES) {
+      p->cam_frames++;
+      if (p->on_camera)
+        p->on_camera(p->ctx, p->cam, p->cam[TLM_CAM_PIXELS]);
+      p->cam_count = 0;
+    }
+  }
+  if (c == '\n')
+    p->cam_count = 0;
+}
+
+
+void Parser_Commit(struct frame_parser *p, size_t n)
+{
+  const unsigned char *b = p->buf;
+  size_t end = p->len + n;
+  size_t i = 0;
+  unsigned char len, sum;
+  size_t k;
+
+  while (i < end) {
+    if (b[i] != PARAM_REPLY_SYNC) {
+      Ascii_Byte(p, b[i++]);
+      continue;
+    }
+
+    if (end - i < 3)
+      break;                         /* wait for the length byte */
+    len = b[i + 2];
+    if (len > PARAM_MAX_PAYLOAD) {
+      Ascii_Byte(p, b[i++]);
+      continue;
+    }
+    if (end - i < (size_t)len + 4)
+      break;                         /* wait for the rest of the frame */
+
+    sum = (unsigned char)(b[i + 1] + len);
+    for (k = 0; k < len; k++)
+      sum += b[i + 3 + k];
+    if (sum != b[i + 3 + len]) {
+      p->bad_frames++;
+      Ascii_Byte(p, b[i++]);
+      continue;
+    }
+
+    p->frames++;
+    p->number = 0;                   /* a frame splits the ASCII around it */
+    p->in_number = 0;
+    if (p->on_frame)
+      p->on_frame(p->ctx, b[i + 1], b + i + 3, len);
+    i += (size_t)len + 4;
+  }
+
+  /* keep only the unfinished frame, at most PARAM_MAX_PAYLOAD + 3 bytes */
+  memmove(p->buf, p->buf + i, end - i);
+  p->len = end - i;
+}
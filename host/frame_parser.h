@@ -0,0 +1,59 @@
+/*******************************************************************************
+* FILE NAME: frame_parser.h
+*
+* DESCRIPTION:
+*  Incremental parser for everything the robot sends on its serial port:
+*  binary reply frames (param_table.h, telemetry.h) mixed with ASCII, which
+*  is where the line-scan camera frames from camera_code.c turn up.
+*
+*  Bytes are read straight into the parser's buffer and frames are handed to
+*  the callbacks as pointers into that buffer, so nothing is copied on the
+*  way through.  Only the unfinished tail of a frame is kept between reads.
+*
+*******************************************************************************/
+
+#ifndef __frame_parser_h_
+#define __frame_parser_h_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../telemetry.h"
+
+#define PARSER_BUF_SIZE         4096
+
+typedef void (*frame_fn)(void *ctx, unsigned char cmd,
+                         const unsigned char *payload, unsigned char len);
+typedef void (*camera_fn)(void *ctx, const uint16_t *pixels, uint16_t exposure);
+
+struct frame_parser {
+  unsigned char buf[PARSER_BUF_SIZE];
+  size_t len;
+
+  /* ASCII camera numbers seen so far in the current line-scan */
+  uint16_t cam[TLM_CAM_VALUES];
+  int cam_count;
+  uint32_t number;
+  int in_number;
+
+  frame_fn on_frame;
+  camera_fn on_camera;
+  void *ctx;
+
+  /* counters for the status line */
+  unsigned long frames, cam_frames, bad_frames;
+};
+
+void Parser_Init(struct frame_parser *p, frame_fn on_frame, camera_fn on_camera, void *ctx);
+
+/* Where the next read() should go, and how much room there is. */
+unsigned char *Parser_Space(struct frame_parser *p, size_t *room);
+
+/* Parses n bytes just read into Parser_Space(). */
+void Parser_Commit(struct frame_parser *p, size_t n);
+
+/* Big endian 16 bit word from a frame payload. */
+#define PAYLOAD_WORD(payload, ofs) \
+  ((uint16_t)(((payload)[ofs] << 8) | (payload)[(ofs) + 1]))
+
+#endif
@@ -0,0 +1,102 @@
+/*******************************************************************************
+* FILE NAME: serial_port.c
+*
+* DESCRIPTION:
+*  Raw 8N1 serial port setup shared by the host tools.  Works the same on a
+*  real USB serial adapter and on a pty, which is what the loopback modes use.
+*
+*******************************************************************************/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "serial_port.h"
+
+static speed_t Baud_To_Speed(long baud)
+{
+  switch (baud) {
+  case 9600:   return B9600;
+  case 19200:  return B19200;
+  case 38400:  return B38400;
+  case 57600:  return B57600;
+  case 115200: return B115200;
+  case 230400: return B230400;
+  default:     return 0;
+  }
+}
+
+
+int Open_Serial_Port(const char *path, long baud)
+{
+  struct termios tio;
+  speed_t speed = Baud_To_Speed(baud);
+  int fd;
+
+  if (speed == 0) {
+    errno = EINVAL;
+    return -1;
+  }
+
+  fd = open(path, O_RDWR | O_NOCTTY);
+  if (fd < 0)
+    return -1;
+
+  if (tcgetattr(fd, &tio) < 0) {
+    close(fd);
+    return -1;
+  }
+  cfmakeraw(&tio);
+  tio.c_cflag |= CLOCAL | CREAD;
+  tio.c_cflag &= ~(CSTOPB | CRTSCTS);
+  tio.c_cc[VMIN] = 0;
+  tio.c_cc[VTIME] = 0;
+  cfsetispeed(&tio, speed);
+  cfsetospeed(&tio, speed);
+  if (tcsetattr(fd, TCSANOW, &tio) < 0) {
+    close(fd);
+    return -1;
+  }
+  tcflush(fd, TCIOFLUSH);
+  return fd;
+}
+
+
+int Read_Serial_Port(int fd, unsigned char *buf, int len, int timeout_ms)
+{
+  struct pollfd pfd;
+  int n;
+
+  pfd.fd = fd;
+  pfd.events = POLLIN;
+  do {
+    n = poll(&pfd, 1, timeout_ms);
+  } while (n < 0 && errno == EINTR);
+  if (n <= 0)
+    return n;
+
+  do {
+    n = (int)read(fd, buf, (size_t)len);
+  } while (n < 0 && errno == EINTR);
+  return n;
+}
+
+
+int Write_Serial_Port(int fd, const unsigned char *buf, int len)
+{
+  int n;
+
+  while (len > 0) {
+    n = (int)write(fd, buf, (size_t)len);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      return -1;
+    }
+    buf += n;
+    len -= n;
+  }
+  return 0;
+}
@@ -0,0 +1,23 @@
+/*******************************************************************************
+* FILE NAME: serial_port.h
+*
+* DESCRIPTION:
+*  Raw 8N1 serial port setup shared by the host tools.
+*
+*******************************************************************************/
+
+#ifndef __serial_port_h_
+#define __serial_port_h_
+
+#define DEFAULT_BAUD            115200
+
+/* Opens a tty (or pty) in raw mode.  Returns the fd, or -1 with errno set. */
+int Open_Serial_Port(const char *path, long baud);
+
+/* Reads up to len bytes, waiting at most timeout_ms.  Returns 0 on timeout. */
+int Read_Serial_Port(int fd, unsigned char *buf, int len, int timeout_ms);
+
+/* Writes all len bytes.  Returns 0, or -1 with errno set. */
+int Write_Serial_Port(int fd, const unsigned char *buf, int len);
+
+#endif
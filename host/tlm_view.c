@@ -0,0 +1,257 @@
+/*******************************************************************************
+* FILE NAME: tlm_view.c
+*
+* DESCRIPTION:
+*  Live terminal view for vextlm.  See tlm_view.h.
+*
+*  Uses the xterm 256 colour grey ramp and half-block characters, so each
+*  text row of the waterfall shows two line-scans (top and bottom half).
+*  The whole screen is built in one buffer and written with a single write.
+*
+*******************************************************************************/
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include "tlm_view.h"
+
+#define GREY_BASE       232
+#define GREY_LEVELS     24
+#define LABEL_WIDTH     12
+#define VALUE_WIDTH     7
+
+#define TLM_ANALOG_NAME(name)   #name,
+static const char *channel_names[VIEW_CHANNELS] = {
+  TLM_ANALOG_LIST(TLM_ANALOG_NAME)
+  "pwm02", "pwm03", "pwm04", "pwm05", "pwm06", "pwm07"
+};
+#undef TLM_ANALOG_NAME
+
+static const char *spark[8] = {
+  "\xe2\x96\x81", "\xe2\x96\x82", "\xe2\x96\x83", "\xe2\x96\x84",
+  "\xe2\x96\x85", "\xe2\x96\x86", "\xe2\x96\x87", "\xe2\x96\x88"
+};
+#define UPPER_HALF      "\xe2\x96\x80"
+
+
+static void Out(struct tlm_view *v, const char *s, size_t n)
+{
+  if (v->out_len + n > v->out_cap) {
+    v->out_cap = (v->out_len + n) * 2;
+    v->out = realloc(v->out, v->out_cap);
+    if (v->out == NULL) {
+      perror("vextlm");
+      exit(1);
+    }
+  }
+  memcpy(v->out + v->out_len, s, n);
+  v->out_len += n;
+}
+
+
+static void Outf(struct tlm_view *v, const char *fmt, ...)
+{
+  char tmp[256];
+  va_list ap;
+  int n;
+
+  va_start(ap, fmt);
+  n = vsnprintf(tmp, sizeof(tmp), fmt, ap);
+  va_end(ap);
+  if (n > 0)
+    Out(v, tmp, (size_t)n < sizeof(tmp) ? (size_t)n : sizeof(tmp) - 1);
+}
+
+
+void View_Open(struct tlm_view *v)
+{
+  memset(v, 0, sizeof(*v));
+  v->active = 1;
+  fputs("\x1b[?1049h\x1b[?25l\x1b[2J", stdout);   /* alternate screen, hide cursor */
+  fflush(stdout);
+}
+
+
+void View_Close(struct tlm_view *v)
+{
+  if (v->active) {
+    fputs("\x1b[0m\x1b[?25h\x1b[?1049l", stdout);
+    fflush(stdout);
+  }
+  free(v->out);
+  v->out = NULL;
+  v->active = 0;
+}
+
+
+void View_Add_Camera(struct tlm_view *v, const uint16_t *pixels)
+{
+  v->cam_head = (v->cam_head + 1) % VIEW_CAM_HISTORY;
+  memcpy(v->cam[v->cam_head], pixels, sizeof(v->cam[0]));
+  if (v->cam_filled < VIEW_CAM_HISTORY)
+    v->cam_filled++;
+}
+
+
+void View_Add_Telemetry(struct tlm_view *v, const uint16_t *analog, const uint8_t *pwm)
+{
+  int c;
+
+  v->head = (v->head + 1) % VIEW_HISTORY;
+  for (c = 0; c < TLM_ANALOG_COUNT; c++)
+    v->series[c][v->head] = analog[c];
+  for (c = 0; c < TLM_PWM_COUNT; c++)
+    v->series[TLM_ANALOG_COUNT + c][v->head] = pwm[c];
+  if (v->filled < VIEW_HISTORY)
+    v->filled++;
+}
+
+
+void View_Status(struct tlm_view *v, const char *fmt, ...)
+{
+  va_list ap;
+
+  va_start(ap, fmt);
+  vsnprintf(v->status, sizeof(v->status), fmt, ap);
+  va_end(ap);
+}
+
+
+// average of the pixels that fall in screen column x of width columns
+static unsigned Cam_Cell(const uint16_t *line, int x, int width)
+{
+  int a = x * TLM_CAM_PIXELS / width;
+  int b = (x + 1) * TLM_CAM_PIXELS / width;
+  unsigned sum = 0;
+  int i;
+
+  if (b <= a)
+    b = a + 1;
+  for (i = a; i < b; i++)
+    sum += line[i];
+  return sum / (unsigned)(b - a);
+}
+
+
+static void Draw_Waterfall(struct tlm_view *v, int lines, int width)
+{
+  unsigned max = 1, val;
+  unsigned n, i, top, bottom;
+  int row, x, g_top, g_bottom, last_top, last_bottom;
+
+  n = (unsigned)lines * 2;
+  if (n > v->cam_filled)
+    n = v->cam_filled;
+
+  /* scale to the brightest pixel on screen so dim scenes still show up */
+  for (i = 0; i < n; i++) {
+    const uint16_t *line = v->cam[(v->cam_head + VIEW_CAM_HISTORY - i) % VIEW_CAM_HISTORY];
+    for (x = 0; x < TLM_CAM_PIXELS; x++)
+      if (line[x] > max)
+        max = line[x];
+  }
+
+  for (row = 0; row < lines; row++) {
+    top = (unsigned)row * 2;
+    bottom = top + 1;
+    last_top = last_bottom = -2;       /* only send colours when they change */
+    for (x = 0; x < width; x++) {
+      g_top = g_bottom = -1;
+      if (top < n) {
+        val = Cam_Cell(v->cam[(v->cam_head + VIEW_CAM_HISTORY - top) % VIEW_CAM_HISTORY], x, width);
+        g_top = (int)(val * (GREY_LEVELS - 1) / max);
+      }
+      if (bottom < n) {
+        val = Cam_Cell(v->cam[(v->cam_head + VIEW_CAM_HISTORY - bottom) % VIEW_CAM_HISTORY], x, width);
+        g_bottom = (int)(val * (GREY_LEVELS - 1) / max);
+      }
+      if (g_top != last_top || g_bottom != last_bottom) {
+        if (g_top < 0)
+          Out(v, "\x1b[0m", 4);
+        else if (g_bottom < 0)
+          Outf(v, "\x1b[0;38;5;%dm", GREY_BASE + g_top);
+        else
+          Outf(v, "\x1b[38;5;%d;48;5;%dm", GREY_BASE + g_top, GREY_BASE + g_bottom);
+        last_top = g_top;
+        last_bottom = g_bottom;
+      }
+      if (g_top < 0)
+        Out(v, " ", 1);
+      else
+        Out(v, UPPER_HALF, 3);
+    }
+    Out(v, "\x1b[0m\x1b[K\r\n", 9);
+  }
+}
+
+
+static void Draw_Series(struct tlm_view *v, int width)
+{
+  unsigned n = (unsigned)width, i, idx;
+  uint16_t lo, hi, s;
+  int c;
+
+  if (n > v->filled)
+    n = v->filled;
+
+  for (c = 0; c < VIEW_CHANNELS; c++) {
+    const uint16_t *ring = v->series[c];
+
+    lo = 0xFFFF;
+    hi = 0;
+    for (i = 0; i < n; i++) {
+      s = ring[(v->head + VIEW_HISTORY - i) % VIEW_HISTORY];
+      if (s < lo) lo = s;
+      if (s > hi) hi = s;
+    }
+
+    Outf(v, "%-*s", LABEL_WIDTH, channel_names[c]);
+    for (i = 0; i < (unsigned)width - n; i++)
+      Out(v, " ", 1);
+    for (i = n; i-- > 0; ) {                          /* oldest on the left */
+      s = ring[(v->head + VIEW_HISTORY - i) % VIEW_HISTORY];
+      idx = (hi > lo) ? (unsigned)(s - lo) * 7 / (unsigned)(hi - lo) : 0;
+      Out(v, spark[idx], 3);
+    }
+    if (v->filled)
+      Outf(v, " %*u", VALUE_WIDTH - 1, ring[v->head]);
+    Out(v, "\x1b[K\r\n", 5);
+  }
+}
+
+
+void View_Draw(struct tlm_view *v, uint64_t now_us, int force)
+{
+  struct winsize ws;
+  int rows = 24, cols = 80, cam_lines, cam_width;
+
+  if (!v->active)
+    return;
+  if (!force && now_us - v->last_draw_us < 1000000 / VIEW_FPS)
+    return;
+  v->last_draw_us = now_us;
+
+  if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0 && ws.ws_row > 0 && ws.ws_col > 0) {
+    rows = ws.ws_row;
+    cols = ws.ws_col;
+  }
+
+  cam_lines = rows - 2 - VIEW_CHANNELS;
+  cam_width = cols < TLM_CAM_PIXELS ? cols : TLM_CAM_PIXELS;
+
+  v->out_len = 0;
+  Out(v, "\x1b[H", 3);
+  Outf(v, "\x1b[7m%-*.*s\x1b[0m\x1b[K\r\n", cols, cols, v->status);
+  if (cam_lines > 0)
+    Draw_Waterfall(v, cam_lines, cam_width);
+  if (cols > LABEL_WIDTH + VALUE_WIDTH + 1)
+    Draw_Series(v, cols - LABEL_WIDTH - VALUE_WIDTH);
+  Out(v, "\x1b[J", 3);
+
+  if (write(STDOUT_FILENO, v->out, v->out_len) < 0)
+    v->active = 0;
+}
@@ -0,0 +1,46 @@
+/*******************************************************************************
+* FILE NAME: tlm_view.h
+*
+* DESCRIPTION:
+*  Live terminal view for vextlm: a scrolling waterfall of the line-scan
+*  camera and a sparkline per sensor and PWM channel.  Every sample goes into
+*  the history; the screen itself is redrawn at most VIEW_FPS times a second
+*  so drawing never holds up ingestion.
+*
+*******************************************************************************/
+
+#ifndef __tlm_view_h_
+#define __tlm_view_h_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../telemetry.h"
+
+#define VIEW_FPS                30
+#define VIEW_CAM_HISTORY        256          /* line-scans kept for the waterfall */
+#define VIEW_HISTORY            512          /* samples kept per channel */
+#define VIEW_CHANNELS           (TLM_ANALOG_COUNT + TLM_PWM_COUNT)
+
+struct tlm_view {
+  uint16_t cam[VIEW_CAM_HISTORY][TLM_CAM_PIXELS];
+  unsigned cam_head, cam_filled;
+  uint16_t series[VIEW_CHANNELS][VIEW_HISTORY];
+  unsigned head, filled;
+  uint64_t last_draw_us;
+  char status[160];
+  char *out;
+  size_t out_len, out_cap;
+  int active;
+};
+
+void View_Open(struct tlm_view *v);
+void View_Close(struct tlm_view *v);
+void View_Add_Camera(struct tlm_view *v, const uint16_t *pixels);
+void View_Add_Telemetry(struct tlm_view *v, const uint16_t *analog, const uint8_t *pwm);
+void View_Status(struct tlm_view *v, const char *fmt, ...);
+
+/* Redraws if a frame interval has passed since the last draw, or if force. */
+void View_Draw(struct tlm_view *v, uint64_t now_us, int force);
+
+#endif
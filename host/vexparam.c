@@ -0,0 +1,311 @@
+/*******************************************************************************
+* FILE NAME: vexparam.c
+*
+* DESCRIPTION:
+*  Host side of the live parameter protocol in param_table.h.  Reads and
+*  writes the robot's tunables over the programming port while it runs.
+*
+* USAGE:
+*  vexparam [-p port] [-b baud] command [command ...]
+*
+*    list               print every parameter and its current value
+*    get NAME           print one parameter (NAME or numeric id)
+*    set NAME VALUE     change one parameter, then show the outputs of the
+*                       first tick that ran with it (needs telemetry.h)
+*    commit             save the current table to EEPROM
+*    defaults           restore the compiled-in defaults (RAM only)
+*    estop              cut the drive to zero at once and hold it there
+*    release            release the e-stop, the drive ramps back up
+*
+*  Commands run in order, e.g.
+*    vexparam set CLIMB_HIGH 380 set CLIMB_COUNT 200 commit
+*
+*******************************************************************************/
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../param_table.h"
+#include "../telemetry.h"
+#include "serial_port.h"
+
+#define DEFAULT_PORT            "/dev/ttyUSB0"
+#define REPLY_TIMEOUT_MS        250
+#define COMMIT_TIMEOUT_MS       3000
+#define TELEMETRY_TIMEOUT_MS    200
+
+#define PARAM_NAME(name, def)   #name,
+static const char *param_names[NUM_PARAMS] = { PARAM_LIST(PARAM_NAME) };
+#undef PARAM_NAME
+
+struct reply {
+  unsigned char cmd;
+  unsigned char len;
+  unsigned char payload[PARAM_MAX_PAYLOAD];
+};
+
+static int port_fd = -1;
+static struct reply last_reply;          /* the reply Transact last returned */
+
+
+static long Now_Ms(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000L + ts.tv_nsec / 1000000L;
+}
+
+
+static int Send_Request(unsigned char cmd, unsigned char id, int value)
+{
+  unsigned char req[PARAM_REQ_LEN];
+
+  req[0] = PARAM_REQ_SYNC;
+  req[1] = cmd;
+  req[2] = id;
+  req[3] = (unsigned char)(value >> 8);
+  req[4] = (unsigned char)value;
+  req[5] = (unsigned char)(req[1] + req[2] + req[3] + req[4]);
+  return Write_Serial_Port(port_fd, req, PARAM_REQ_LEN);
+}
+
+
+/*
+ *  Waits for the next valid frame of any type, skipping the robot's printf
+ *  output.  Returns 1 with *r filled in, or 0 on timeout.  Telemetry frames
+ *  come every tick, so callers that loop on this pass the time left on one
+ *  overall deadline rather than a fresh timeout each call.
+ */
+static int Wait_Reply(struct reply *r, long timeout_ms)
+{
+  int state = 0;
+  unsigned char pos = 0, sum = 0;
+  long deadline = Now_Ms() + timeout_ms;
+  long left;
+  unsigned char c;
+  int n;
+
+  while ((left = deadline - Now_Ms()) > 0) {
+    n = Read_Serial_Port(port_fd, &c, 1, (int)left);   // one byte so nothing is left unread
+    if (n < 0) {
+      perror("vexparam: read");
+      exit(1);
+    }
+    if (n == 0)
+      continue;
+
+    switch (state) {
+    case 0:     // sync
+      if (c == PARAM_REPLY_SYNC)
+        state = 1;
+      break;
+    case 1:     // cmd
+      r->cmd = c;
+      sum = c;
+      state = 2;
+      break;
+    case 2:     // len
+      r->len = c;
+      sum += c;
+      pos = 0;
+      state = (c == 0) ? 4 : 3;
+      if (c > PARAM_MAX_PAYLOAD)
+        state = 0;
+      break;
+    case 3:     // payload
+      r->payload[pos++] = c;
+      sum += c;
+      if (pos == r->len)
+        state = 4;
+      break;
+    case 4:     // checksum
+      state = 0;
+      if (c == sum)
+        return 1;
+      break;
+    }
+  }
+  return 0;
+}
+
+
+// sends one request and waits for the matching reply, returns the value
+static int Transact(unsigned char cmd, unsigned char id, int value, int timeout_ms)
+{
+  struct reply r = { 0 };
+  long deadline = Now_Ms() + timeout_ms;
+
+  if (Send_Request(cmd, id, value) < 0) {
+    perror("vexparam: write");
+    exit(1);
+  }
+  while (Wait_Reply(&r, deadline - Now_Ms())) {
+    if (r.cmd == TLM_FRAME_CMD || r.len < 3)
+      continue;
+    if (r.cmd == PARAM_CMD_BUSY && cmd == PARAM_CMD_COMMIT)
+      continue;                /* a save was already running, wait for its W */
+    if (r.cmd == PARAM_CMD_BUSY) {
+      fprintf(stderr, "vexparam: robot is saving to EEPROM, '%c' refused, try again\n", cmd);
+      exit(1);
+    }
+    if (r.cmd == PARAM_CMD_ERROR) {
+      fprintf(stderr, "vexparam: robot rejected '%c' for id %u\n", cmd, r.payload[0]);
+      exit(1);
+    }
+    if (r.cmd == cmd) {
+      last_reply = r;
+      return (short)((r.payload[1] << 8) | r.payload[2]);
+    }
+  }
+  fprintf(stderr, "vexparam: no reply to '%c' (is the robot on and the port right?)\n", cmd);
+  exit(1);
+}
+
+
+/*
+ *  Prints the outputs of the first tick that ran after a SET was applied.
+ *  The SET reply carries the tick of the last snapshot taken before it, so
+ *  any frame still queued from earlier ticks is skipped by its tick number.
+ */
+static void Show_Next_Tick(void)
+{
+  struct reply r;
+  unsigned short before, tick;
+  int i;
+  long deadline = Now_Ms() + TELEMETRY_TIMEOUT_MS;
+
+  if (last_reply.len < 5) {
+    printf("  (robot did not send a tick with the SET reply)\n");
+    return;
+  }
+  before = (unsigned short)((last_reply.payload[3] << 8) | last_reply.payload[4]);
+
+  while (Wait_Reply(&r, deadline - Now_Ms())) {
+    if (r.cmd != TLM_FRAME_CMD || r.len != TLM_PAYLOAD_LEN)
+      continue;
+    tick = (unsigned short)((r.payload[TLM_OFS_TICK] << 8) | r.payload[TLM_OFS_TICK + 1]);
+    if ((short)(tick - before) <= 0)       /* wraps at 65536 */
+      continue;
+    printf("  next tick %u:", tick);
+    for (i = 0; i < TLM_PWM_COUNT; i++)
+      printf(" pwm%02d=%u", TLM_PWM_FIRST + i, r.payload[TLM_OFS_PWM + i]);
+    printf(" auto_mode=%u drive_state=%u estop=%u\n", r.payload[TLM_OFS_AUTO_MODE],
+           r.payload[TLM_OFS_DRIVE_STATE], r.payload[TLM_OFS_ESTOP]);
+    return;
+  }
+  printf("  (no telemetry from the robot, is Telemetry_Service() called?)\n");
+}
+
+
+static int Lookup_Param(const char *name)
+{
+  char *end;
+  long id;
+  int i;
+
+  for (i = 0; i < NUM_PARAMS; i++) {
+    if (strcasecmp(name, param_names[i]) == 0)
+      return i;
+  }
+  id = strtol(name, &end, 0);
+  if (*name != '\0' && *end == '\0' && id >= 0 && id < NUM_PARAMS)
+    return (int)id;
+
+  fprintf(stderr, "vexparam: unknown parameter '%s'\n", name);
+  exit(2);
+}
+
+
+static long Parse_Value(const char *s)
+{
+  char *end;
+  long v = strtol(s, &end, 0);
+
+  if (*s == '\0' || *end != '\0' || v < -32768 || v > 32767) {
+    fprintf(stderr, "vexparam: bad value '%s'\n", s);
+    exit(2);
+  }
+  return v;
+}
+
+
+static void Usage(void)
+{
+  fprintf(stderr,
+          "usage: vexparam [-p port] [-b baud] command [command ...]\n"
+          "  list | get NAME | set NAME VALUE | commit | defaults | estop | release\n");
+  exit(2);
+}
+
+
+int main(int argc, char **argv)
+{
+  const char *port = DEFAULT_PORT;
+  long baud = DEFAULT_BAUD;
+  int opt, i, id, count, old, now;
+
+  while ((opt = getopt(argc, argv, "p:b:")) != -1) {
+    switch (opt) {
+    case 'p': port = optarg; break;
+    case 'b': baud = atol(optarg); break;
+    default:  Usage();
+    }
+  }
+  if (optind >= argc)
+    Usage();
+
+  port_fd = Open_Serial_Port(port, baud);
+  if (port_fd < 0) {
+    fprintf(stderr, "vexparam: %s: %s\n", port, strerror(errno));
+    return 1;
+  }
+
+  for (i = optind; i < argc; i++) {
+    if (strcmp(argv[i], "list") == 0) {
+      count = Transact(PARAM_CMD_COUNT, 0, 0, REPLY_TIMEOUT_MS);
+      if (count != NUM_PARAMS)
+        fprintf(stderr, "vexparam: robot has %d parameters, this tool knows %d\n",
+                count, NUM_PARAMS);
+      for (id = 0; id < NUM_PARAMS && id < count; id++)
+        printf("%3d %-18s %6d\n", id, param_names[id],
+               Transact(PARAM_CMD_GET, (unsigned char)id, 0, REPLY_TIMEOUT_MS));
+    }
+    else if (strcmp(argv[i], "get") == 0 && i + 1 < argc) {
+      id = Lookup_Param(argv[++i]);
+      printf("%s = %d\n", param_names[id],
+             Transact(PARAM_CMD_GET, (unsigned char)id, 0, REPLY_TIMEOUT_MS));
+    }
+    else if (strcmp(argv[i], "set") == 0 && i + 2 < argc) {
+      id = Lookup_Param(argv[++i]);
+      now = (int)Parse_Value(argv[++i]);
+      old = Transact(PARAM_CMD_GET, (unsigned char)id, 0, REPLY_TIMEOUT_MS);
+      now = Transact(PARAM_CMD_SET, (unsigned char)id, now, REPLY_TIMEOUT_MS);
+      printf("%s = %d (was %d)\n", param_names[id], now, old);
+      Show_Next_Tick();
+    }
+    else if (strcmp(argv[i], "commit") == 0) {
+      count = Transact(PARAM_CMD_COMMIT, 0, 0, COMMIT_TIMEOUT_MS);
+      printf("saved %d bytes to EEPROM\n", count);
+    }
+    else if (strcmp(argv[i], "estop") == 0 || strcmp(argv[i], "release") == 0) {
+      now = Transact(PARAM_CMD_ESTOP, 0, argv[i][0] == 'e', REPLY_TIMEOUT_MS);
+      printf("e-stop %s\n", now ? "on, drive held at zero" : "released");
+    }
+    else if (strcmp(argv[i], "defaults") == 0) {
+      Transact(PARAM_CMD_DEFAULTS, 0, 0, REPLY_TIMEOUT_MS);
+      printf("defaults restored (not saved, use commit)\n");
+    }
+    else {
+      Usage();
+    }
+  }
+
+  close(port_fd);
+  return 0;
+}
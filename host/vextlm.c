@@ -0,0 +1,654 @@
+/*******************************************************************************
+* FILE NAME: vextlm.c
+*
+* DESCRIPTION:
+*  Records the robot's telemetry (telemetry.h) and the line-scan camera
+*  stream (camera_code.c) into column-oriented session files (coltable.h),
+*  with a live terminal view while it runs.
+*
+* USAGE:
+*  vextlm record [-p port] [-c camera_port] [-b baud] [-o session] [-q]
+*      Read from the robot (and optionally a separate camera port).
+*  vextlm loopback [-o session] [-d seconds] [-q]
+*      Same as record, fed by a simulated robot on a local pty.
+*  vextlm play session [-t start_seconds] [-s speed]
+*      Replay a recording from any point without loading it into memory.
+*  vextlm info session
+*      Print the size, length and columns of a recording.
+*
+*  A session is two files, <session>.tlm and <session>.cam.  -q turns the
+*  live view off and prints a status line once a second instead.
+*
+*******************************************************************************/
+
+#define _DEFAULT_SOURCE
+#define _XOPEN_SOURCE 600      /* posix_openpt */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../param_table.h"
+#include "../telemetry.h"
+#include "coltable.h"
+#include "frame_parser.h"
+#include "serial_port.h"
+#include "tlm_view.h"
+
+#define DEFAULT_PORT            "/dev/ttyUSB0"
+#define FLUSH_INTERVAL_US       1000000
+#define POLL_MS                 10
+#define TICK_US                 17000
+#define MAX_INPUTS              2
+
+struct session {
+  struct table_writer tlm, cam;
+  int col_tlm_t, col_tick, col_analog, col_pwm, col_auto_mode, col_drive_state, col_estop;
+  int col_cam_t, col_exposure, col_pixels;
+  uint64_t t0_us, now_us;
+  uint16_t last_tick;
+  int have_tick;
+  unsigned long dropped_ticks;
+  struct tlm_view view;
+  int quiet;
+};
+
+#define TLM_ANALOG_NAME(name)   #name,
+static const char *analog_names[TLM_ANALOG_COUNT] = { TLM_ANALOG_LIST(TLM_ANALOG_NAME) };
+#undef TLM_ANALOG_NAME
+
+static volatile sig_atomic_t stop_requested = 0;
+
+
+static void On_Signal(int sig)
+{
+  (void)sig;
+  stop_requested = 1;
+}
+
+
+static uint64_t Now_Us(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+
+static uint64_t Wall_Us(void)
+{
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+  return (uint64_t)tv.tv_sec * 1000000u + (uint64_t)tv.tv_usec;
+}
+
+
+static void Die(const char *what)
+{
+  fprintf(stderr, "vextlm: %s: %s\n", what, strerror(errno));
+  exit(1);
+}
+
+
+/*******************************************************************************
+*  Recording
+*******************************************************************************/
+
+static void Put_U64(void *cell, uint64_t v) { memcpy(cell, &v, sizeof(v)); }
+static void Put_U16(void *cell, uint16_t v) { memcpy(cell, &v, sizeof(v)); }
+
+
+static void On_Frame(void *ctx, unsigned char cmd, const unsigned char *payload, unsigned char len)
+{
+  struct session *s = ctx;
+  struct table_writer *w = &s->tlm;
+  uint16_t analog[TLM_ANALOG_COUNT], tick;
+  int i;
+
+  if (cmd != TLM_FRAME_CMD || len != TLM_PAYLOAD_LEN)
+    return;      /* parameter replies are vexparam's business */
+
+  tick = PAYLOAD_WORD(payload, TLM_OFS_TICK);
+  if (s->have_tick)
+    s->dropped_ticks += (uint16_t)(tick - s->last_tick - 1);
+  s->last_tick = tick;
+  s->have_tick = 1;
+
+  Put_U64(Table_Cell(w, s->col_tlm_t), s->now_us - s->t0_us);
+  Put_U16(Table_Cell(w, s->col_tick), tick);
+  for (i = 0; i < TLM_ANALOG_COUNT; i++) {
+    analog[i] = PAYLOAD_WORD(payload, TLM_OFS_ANALOG + 2 * i);
+    Put_U16(Table_Cell(w, s->col_analog + i), analog[i]);
+  }
+  for (i = 0; i < TLM_PWM_COUNT; i++)
+    *(uint8_t *)Table_Cell(w, s->col_pwm + i) = payload[TLM_OFS_PWM + i];
+  *(uint8_t *)Table_Cell(w, s->col_auto_mode) = payload[TLM_OFS_AUTO_MODE];
+  *(uint8_t *)Table_Cell(w, s->col_drive_state) = payload[TLM_OFS_DRIVE_STATE];
+  *(uint8_t *)Table_Cell(w, s->col_estop) = payload[TLM_OFS_ESTOP];
+  if (Table_Next_Row(w) < 0)
+    Die("write telemetry");
+
+  View_Add_Telemetry(&s->view, analog, payload + TLM_OFS_PWM);
+}
+
+
+static void On_Camera(void *ctx, const uint16_t *pixels, uint16_t exposure)
+{
+  struct session *s = ctx;
+  struct table_writer *w = &s->cam;
+
+  Put_U64(Table_Cell(w, s->col_cam_t), s->now_us - s->t0_us);
+  Put_U16(Table_Cell(w, s->col_exposure), exposure);
+  memcpy(Table_Cell(w, s->col_pixels), pixels, TLM_CAM_PIXELS * sizeof(uint16_t));
+  if (Table_Next_Row(w) < 0)
+    Die("write camera");
+
+  View_Add_Camera(&s->view, pixels);
+}
+
+
+static void Open_Session(struct session *s, const char *name)
+{
+  char path[1024];
+  uint64_t wall = Wall_Us();
+  char col[16];
+  int i;
+
+  Table_Init(&s->tlm);
+  s->col_tlm_t = Table_Add_Column(&s->tlm, "t_us", 8, 1);
+  s->col_tick = Table_Add_Column(&s->tlm, "tick", 2, 1);
+  for (i = 0; i < TLM_ANALOG_COUNT; i++)      /* consecutive, so col_analog + i */
+    s->col_analog = Table_Add_Column(&s->tlm, analog_names[i], 2, 1) - i;
+  for (i = 0; i < TLM_PWM_COUNT; i++) {
+    snprintf(col, sizeof(col), "pwm%02d", TLM_PWM_FIRST + i);
+    s->col_pwm = Table_Add_Column(&s->tlm, col, 1, 1) - i;
+  }
+  s->col_auto_mode = Table_Add_Column(&s->tlm, "auto_mode", 1, 1);
+  s->col_drive_state = Table_Add_Column(&s->tlm, "drive_state", 1, 1);
+  s->col_estop = Table_Add_Column(&s->tlm, "drive_estop", 1, 1);
+
+  Table_Init(&s->cam);
+  s->col_cam_t = Table_Add_Column(&s->cam, "t_us", 8, 1);
+  s->col_exposure = Table_Add_Column(&s->cam, "exposure_us", 2, 1);
+  s->col_pixels = Table_Add_Column(&s->cam, "pixels", 2, TLM_CAM_PIXELS);
+
+  snprintf(path, sizeof(path), "%s.tlm", name);
+  if (Table_Create_File(&s->tlm, path, wall) < 0)
+    Die(path);
+  snprintf(path, sizeof(path), "%s.cam", name);
+  if (Table_Create_File(&s->cam, path, wall) < 0)
+    Die(path);
+}
+
+
+static void Close_Session(struct session *s)
+{
+  if (Table_Close(&s->tlm) < 0 || Table_Close(&s->cam) < 0)
+    Die("close session");
+}
+
+
+static void Default_Session_Name(char *buf, size_t len)
+{
+  time_t t = time(NULL);
+
+  strftime(buf, len, "session-%Y%m%d-%H%M%S", localtime(&t));
+}
+
+
+// reads every input until stopped (or for duration_us if non-zero)
+static void Record(struct session *s, const int *fds, int nfds, uint64_t duration_us)
+{
+  static struct frame_parser parsers[MAX_INPUTS];
+  struct pollfd pfd[MAX_INPUTS];
+  uint64_t last_flush, last_status;
+  unsigned long frames, cam_frames, bad;
+  unsigned char *space;
+  size_t room;
+  ssize_t got;
+  int i, n;
+
+  for (i = 0; i < nfds; i++) {
+    Parser_Init(&parsers[i], On_Frame, On_Camera, s);
+    pfd[i].fd = fds[i];
+    pfd[i].events = POLLIN;
+  }
+
+  s->t0_us = s->now_us = Now_Us();
+  last_flush = last_status = s->t0_us;
+  if (!s->quiet)
+    View_Open(&s->view);
+
+  while (!stop_requested) {
+    n = poll(pfd, (nfds_t)nfds, POLL_MS);
+    if (n < 0 && errno != EINTR)
+      Die("poll");
+    s->now_us = Now_Us();
+
+    for (i = 0; n > 0 && i < nfds; i++) {
+      if (pfd[i].revents & (POLLERR | POLLHUP | POLLNVAL)) {
+        stop_requested = 1;
+        break;
+      }
+      if (!(pfd[i].revents & POLLIN))
+        continue;
+      space = Parser_Space(&parsers[i], &room);
+      got = read(fds[i], space, room);
+      if (got < 0 && errno != EINTR && errno != EAGAIN)
+        Die("read");
+      if (got > 0)
+        Parser_Commit(&parsers[i], (size_t)got);
+    }
+
+    if (s->now_us - last_flush >= FLUSH_INTERVAL_US) {
+      if (Table_Flush(&s->tlm) < 0 || Table_Flush(&s->cam) < 0)
+        Die("flush session");
+      last_flush = s->now_us;
+    }
+
+    frames = cam_frames = bad = 0;
+    for (i = 0; i < nfds; i++) {
+      frames += parsers[i].frames;
+      cam_frames += parsers[i].cam_frames;
+      bad += parsers[i].bad_frames;
+    }
+    View_Status(&s->view, " %6.1fs  telemetry %llu rows  camera %llu rows  dropped %lu  bad %lu  frames %lu",
+                (double)(s->now_us - s->t0_us) / 1e6,
+                (unsigned long long)s->tlm.h.rows, (unsigned long long)s->cam.h.rows,
+                s->dropped_ticks, bad, frames);
+    View_Draw(&s->view, s->now_us, 0);
+    if (s->quiet && s->now_us - last_status >= 1000000) {
+      fprintf(stderr, "%s\n", s->view.status);
+      last_status = s->now_us;
+    }
+
+    if (duration_us && s->now_us - s->t0_us >= duration_us)
+      break;
+  }
+
+  View_Close(&s->view);
+}
+
+
+/*******************************************************************************
+*  Simulated robot for loopback mode
+*******************************************************************************/
+
+static void Sim_Send_Frame(int fd, unsigned char cmd, const unsigned char *payload, unsigned char len)
+{
+  unsigned char frame[PARAM_MAX_PAYLOAD + 4];
+  unsigned char sum = (unsigned char)(cmd + len);
+  int i;
+
+  frame[0] = PARAM_REPLY_SYNC;
+  frame[1] = cmd;
+  frame[2] = len;
+  for (i = 0; i < len; i++) {
+    frame[3 + i] = payload[i];
+    sum += payload[i];
+  }
+  frame[3 + len] = sum;
+  if (Write_Serial_Port(fd, frame, len + 4) < 0)
+    _exit(0);
+}
+
+
+// writes telemetry every tick and a camera line-scan every other tick
+static void Simulate_Robot(int fd)
+{
+  unsigned char p[TLM_PAYLOAD_LEN];
+  char line[TLM_CAM_VALUES * 6 + 2];
+  uint16_t tick = 0;
+  double t, spot;
+  int i, n, v;
+
+  for (;;) {
+    t = tick * (TICK_US / 1e6);
+
+    p[TLM_OFS_TICK] = (unsigned char)(tick >> 8);
+    p[TLM_OFS_TICK + 1] = (unsigned char)tick;
+    for (i = 0; i < TLM_ANALOG_COUNT; i++) {
+      v = (int)(512 + 400 * sin(t * (0.5 + 0.3 * i) + i));
+      p[TLM_OFS_ANALOG + 2 * i] = (unsigned char)(v >> 8);
+      p[TLM_OFS_ANALOG + 2 * i + 1] = (unsigned char)v;
+    }
+    for (i = 0; i < TLM_PWM_COUNT; i++)
+      p[TLM_OFS_PWM + i] = (unsigned char)(127 + 100 * sin(t * 0.7 + i));
+    p[TLM_OFS_AUTO_MODE] = (unsigned char)((tick / 600) % 6);
+    p[TLM_OFS_DRIVE_STATE] = (unsigned char)((tick / 60) % 9);
+    p[TLM_OFS_ESTOP] = (unsigned char)((tick / 1000) % 4 == 3);
+    Sim_Send_Frame(fd, TLM_FRAME_CMD, p, TLM_PAYLOAD_LEN);
+
+    if ((tick & 1) == 0) {
+      spot = 64 + 50 * sin(t * 0.8);     /* a light source drifting across */
+      n = 0;
+      for (i = 0; i < TLM_CAM_PIXELS; i++) {
+        v = (int)(80 + 900 * exp(-(i - spot) * (i - spot) / 40.0)) + rand() % 40;
+        n += sprintf(line + n, "%d ", v);
+      }
+      n += sprintf(line + n, "%d\n", 2000);
+      if (Write_Serial_Port(fd, (unsigned char *)line, n) < 0)
+        _exit(0);
+    }
+
+    tick++;
+    usleep(TICK_US);
+  }
+}
+
+
+static int Open_Loopback(pid_t *child)
+{
+  int master, fd;
+  char *slave;
+
+  master = posix_openpt(O_RDWR | O_NOCTTY);
+  if (master < 0 || grantpt(master) < 0 || unlockpt(master) < 0 ||
+      (slave = ptsname(master)) == NULL)
+    Die("pty");
+
+  fd = Open_Serial_Port(slave, DEFAULT_BAUD);
+  if (fd < 0)
+    Die(slave);
+
+  *child = fork();
+  if (*child < 0)
+    Die("fork");
+  if (*child == 0) {
+    close(fd);
+    signal(SIGINT, SIG_IGN);
+    signal(SIGTERM, SIG_DFL);
+    Simulate_Robot(master);
+  }
+  close(master);
+  return fd;
+}
+
+
+/*******************************************************************************
+*  Playback
+*******************************************************************************/
+
+static int Map_Optional(struct table_map *m, const char *name, const char *ext)
+{
+  char path[1024];
+
+  snprintf(path, sizeof(path), "%s.%s", name, ext);
+  if (Table_Map(m, path) == 0)
+    return 1;
+  if (errno != ENOENT)
+    Die(path);
+  m->fd = -1;
+  return 0;
+}
+
+
+// a column of the given shape, or -1 if it is missing or has another shape
+static int Find_Column(const struct table_map *m, const char *name, int elem_bytes, int count)
+{
+  int c = Table_Find_Column(m, name);
+
+  if (c < 0 || m->h->cols[c].elem_bytes != elem_bytes || m->h->cols[c].count != count)
+    return -1;
+  return c;
+}
+
+
+static uint64_t Row_Time(const struct table_map *m, int col, uint64_t row)
+{
+  uint64_t v;
+
+  memcpy(&v, Table_At(m, col, row), sizeof(v));
+  return v;
+}
+
+
+static void Feed_Telemetry(struct tlm_view *v, const struct table_map *m, const int *cols, uint64_t row)
+{
+  uint16_t analog[TLM_ANALOG_COUNT];
+  uint8_t pwm[TLM_PWM_COUNT];
+  int i;
+
+  for (i = 0; i < TLM_ANALOG_COUNT; i++)
+    memcpy(&analog[i], Table_At(m, cols[i], row), sizeof(uint16_t));
+  for (i = 0; i < TLM_PWM_COUNT; i++)
+    pwm[i] = *(const uint8_t *)Table_At(m, cols[TLM_ANALOG_COUNT + i], row);
+  View_Add_Telemetry(v, analog, pwm);
+}
+
+
+static void Feed_Camera(struct tlm_view *v, const struct table_map *m, int col, uint64_t row)
+{
+  uint16_t pixels[TLM_CAM_PIXELS];
+
+  memcpy(pixels, Table_At(m, col, row), sizeof(pixels));
+  View_Add_Camera(v, pixels);
+}
+
+
+static int Play(const char *name, double start_s, double speed)
+{
+  static struct tlm_view view;
+  struct table_map tlm, cam;
+  int have_tlm, have_cam, tlm_t = -1, cam_t = -1, cam_px = -1;
+  int cols[VIEW_CHANNELS];
+  uint64_t tlm_row = 0, cam_row = 0, start_us, end_us = 0, play_us, wall0, r;
+  char col[16];
+  int i;
+
+  have_tlm = Map_Optional(&tlm, name, "tlm");
+  have_cam = Map_Optional(&cam, name, "cam");
+  if (!have_tlm && !have_cam) {
+    fprintf(stderr, "vextlm: no %s.tlm or %s.cam\n", name, name);
+    return 1;
+  }
+
+  if (have_tlm) {
+    for (i = 0; i < TLM_ANALOG_COUNT; i++)
+      cols[i] = Find_Column(&tlm, analog_names[i], 2, 1);
+    for (i = 0; i < TLM_PWM_COUNT; i++) {
+      snprintf(col, sizeof(col), "pwm%02d", TLM_PWM_FIRST + i);
+      cols[TLM_ANALOG_COUNT + i] = Find_Column(&tlm, col, 1, 1);
+    }
+    tlm_t = Find_Column(&tlm, "t_us", 8, 1);
+    for (i = 0; i < VIEW_CHANNELS; i++)
+      if (cols[i] < 0)
+        tlm_t = -1;
+    if (tlm_t < 0) {
+      fprintf(stderr, "vextlm: %s.tlm is missing columns\n", name);
+      return 1;
+    }
+    if (tlm.rows)
+      end_us = Row_Time(&tlm, tlm_t, tlm.rows - 1);
+  }
+  if (have_cam) {
+    cam_t = Find_Column(&cam, "t_us", 8, 1);
+    cam_px = Find_Column(&cam, "pixels", 2, TLM_CAM_PIXELS);
+    if (cam_t < 0 || cam_px < 0) {
+      fprintf(stderr, "vextlm: %s.cam is missing columns\n", name);
+      return 1;
+    }
+    if (cam.rows && Row_Time(&cam, cam_t, cam.rows - 1) > end_us)
+      end_us = Row_Time(&cam, cam_t, cam.rows - 1);
+  }
+
+  /* seek, then back up far enough to fill the screen history */
+  View_Open(&view);
+  start_us = (uint64_t)(start_s * 1e6);
+  if (have_tlm) {
+    tlm_row = Table_Lower_Bound(&tlm, tlm_t, start_us);
+    for (r = tlm_row > VIEW_HISTORY ? tlm_row - VIEW_HISTORY : 0; r < tlm_row; r++)
+      Feed_Telemetry(&view, &tlm, cols, r);
+  }
+  if (have_cam) {
+    cam_row = Table_Lower_Bound(&cam, cam_t, start_us);
+    for (r = cam_row > VIEW_CAM_HISTORY ? cam_row - VIEW_CAM_HISTORY : 0; r < cam_row; r++)
+      Feed_Camera(&view, &cam, cam_px, r);
+  }
+
+  wall0 = Now_Us();
+  while (!stop_requested) {
+    play_us = start_us + (uint64_t)((double)(Now_Us() - wall0) * speed);
+
+    while (have_tlm && tlm_row < tlm.rows && Row_Time(&tlm, tlm_t, tlm_row) <= play_us)
+      Feed_Telemetry(&view, &tlm, cols, tlm_row++);
+    while (have_cam && cam_row < cam.rows && Row_Time(&cam, cam_t, cam_row) <= play_us)
+      Feed_Camera(&view, &cam, cam_px, cam_row++);
+
+    View_Status(&view, " %s  %8.2fs / %.2fs  x%.2g", name,
+                (double)play_us / 1e6, (double)end_us / 1e6, speed);
+    View_Draw(&view, Now_Us(), 0);
+
+    if (play_us > end_us)
+      break;
+    usleep(1000000 / VIEW_FPS);
+  }
+
+  View_Close(&view);
+  if (have_tlm)
+    Table_Unmap(&tlm);
+  if (have_cam)
+    Table_Unmap(&cam);
+  return 0;
+}
+
+
+static int Info(const char *name)
+{
+  static const char *ext[2] = { "tlm", "cam" };
+  struct table_map m;
+  uint64_t first, last;
+  uint32_t c;
+  int t, i, found = 0;
+
+  for (i = 0; i < 2; i++) {
+    if (!Map_Optional(&m, name, ext[i]))
+      continue;
+    found = 1;
+    t = Find_Column(&m, "t_us", 8, 1);
+    first = last = 0;
+    if (t >= 0 && m.rows) {
+      first = Row_Time(&m, t, 0);
+      last = Row_Time(&m, t, m.rows - 1);
+    }
+    printf("%s.%s: %llu rows, %.2fs, %zu bytes, %u rows/chunk\n", name, ext[i],
+           (unsigned long long)m.rows, (double)(last - first) / 1e6, m.size,
+           m.h->chunk_rows);
+    for (c = 0; c < m.h->ncols; c++)
+      printf("  %-14.*s %u x %u bytes\n", COLTABLE_NAME_LEN, m.h->cols[c].name,
+             m.h->cols[c].count, m.h->cols[c].elem_bytes);
+    Table_Unmap(&m);
+  }
+  if (!found) {
+    fprintf(stderr, "vextlm: no %s.tlm or %s.cam\n", name, name);
+    return 1;
+  }
+  return 0;
+}
+
+
+static void Usage(void)
+{
+  fprintf(stderr,
+          "usage: vextlm record [-p port] [-c camera_port] [-b baud] [-o session] [-q]\n"
+          "       vextlm loopback [-o session] [-d seconds] [-q]\n"
+          "       vextlm play session [-t start_seconds] [-s speed]\n"
+          "       vextlm info session\n");
+  exit(2);
+}
+
+
+int main(int argc, char **argv)
+{
+  static struct session s;
+  const char *port = DEFAULT_PORT, *cam_port = NULL, *cmd;
+  char name_buf[64];
+  const char *name = NULL;
+  long baud = DEFAULT_BAUD;
+  double start_s = 0, speed = 1, duration_s = 0;
+  int fds[MAX_INPUTS], nfds = 0, opt, loopback;
+  pid_t child = -1;
+
+  if (argc < 2)
+    Usage();
+  cmd = argv[1];
+  optind = 2;
+
+  signal(SIGINT, On_Signal);
+  signal(SIGTERM, On_Signal);
+  signal(SIGPIPE, SIG_IGN);
+
+  if (strcmp(cmd, "play") == 0 || strcmp(cmd, "info") == 0) {
+    if (argc < 3)
+      Usage();
+    name = argv[2];
+    optind = 3;
+    while ((opt = getopt(argc, argv, "t:s:")) != -1) {
+      switch (opt) {
+      case 't': start_s = atof(optarg); break;
+      case 's': speed = atof(optarg); break;
+      default:  Usage();
+      }
+    }
+    if (speed <= 0)
+      Usage();
+    return cmd[0] == 'p' ? Play(name, start_s, speed) : Info(name);
+  }
+
+  loopback = strcmp(cmd, "loopback") == 0;
+  if (!loopback && strcmp(cmd, "record") != 0)
+    Usage();
+
+  while ((opt = getopt(argc, argv, "p:c:b:o:d:q")) != -1) {
+    switch (opt) {
+    case 'p': port = optarg; break;
+    case 'c': cam_port = optarg; break;
+    case 'b': baud = atol(optarg); break;
+    case 'o': name = optarg; break;
+    case 'd': duration_s = atof(optarg); break;
+    case 'q': s.quiet = 1; break;
+    default:  Usage();
+    }
+  }
+  if (name == NULL) {
+    Default_Session_Name(name_buf, sizeof(name_buf));
+    name = name_buf;
+  }
+
+  if (loopback) {
+    fds[nfds++] = Open_Loopback(&child);
+  }
+  else {
+    if ((fds[nfds] = Open_Serial_Port(port, baud)) < 0)
+      Die(port);
+    nfds++;
+    if (cam_port != NULL) {
+      if ((fds[nfds] = Open_Serial_Port(cam_port, baud)) < 0)
+        Die(cam_port);
+      nfds++;
+    }
+  }
+
+  Open_Session(&s, name);
+  Record(&s, fds, nfds, (uint64_t)(duration_s * 1e6));
+  Close_Session(&s);
+
+  if (child > 0) {
+    kill(child, SIGTERM);
+    waitpid(child, NULL, 0);
+  }
+  fprintf(stderr, "vextlm: %llu telemetry rows, %llu camera rows in %s.tlm / %s.cam\n",
+          (unsigned long long)s.tlm.h.rows, (unsigned long long)s.cam.h.rows, name, name);
+  return 0;
+}
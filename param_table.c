@@ -0,0 +1,325 @@
+/*******************************************************************************
+* FILE NAME: param_table.c
+*
+* DESCRIPTION:
+*  RAM copy of the tunable parameters, the serial get/set command parser and
+*  the EEPROM save/load.  See param_table.h for the wire format.
+*
+*  Everything here runs from the fast loop so the 17ms master packet handler
+*  never waits on the serial port or on an EEPROM write:
+*    - received bytes are fed one at a time into a small state machine,
+*    - a commit writes at most one EEPROM byte per pass and only starts the
+*      next one when the previous write has finished.
+*
+* USAGE:
+*  Call Param_Initialization() from User_Initialization after the serial
+*  port is set up, and Param_Service() from Process_Data_From_Local_IO in
+*  user_routines_fast.c.
+*
+*******************************************************************************/
+
+#include "ifi_aliases.h"
+#include "ifi_default.h"
+#include "ifi_utilities.h"
+#include "param_table.h"
+#include "telemetry.h"
+
+#define PARAM_EE_BASE           0x000
+#define PARAM_EE_MAGIC          0xB5
+#define PARAM_EE_SIZE           (2 * NUM_PARAMS + 3)   // magic, count, values, checksum
+
+#define PARAM_DEFAULT(name, def)   def,
+rom const int param_defaults[NUM_PARAMS] = { PARAM_LIST(PARAM_DEFAULT) };
+#undef PARAM_DEFAULT
+
+int params[NUM_PARAMS];
+
+unsigned char req_buf[PARAM_REQ_LEN];
+unsigned char req_pos = 0;
+unsigned int commit_pos = 0;       // 0 = no commit running
+unsigned char commit_sum = 0;
+
+
+static unsigned char EE_Read(unsigned int addr)
+{
+  EEADRH = (unsigned char)(addr >> 8);
+  EEADR = (unsigned char)addr;
+  EECON1bits.EEPGD = 0;
+  EECON1bits.CFGS = 0;
+  EECON1bits.RD = 1;
+  return EEDATA;
+}
+
+
+// starts an EEPROM write, caller must wait for EECON1bits.WR to clear
+static void EE_Start_Write(unsigned int addr, unsigned char data)
+{
+  unsigned char gie = INTCONbits.GIE;
+
+  EEADRH = (unsigned char)(addr >> 8);
+  EEADR = (unsigned char)addr;
+  EEDATA = data;
+  EECON1bits.EEPGD = 0;
+  EECON1bits.CFGS = 0;
+  EECON1bits.WREN = 1;
+  INTCONbits.GIE = 0;      // required unlock sequence
+  EECON2 = 0x55;
+  EECON2 = 0xAA;
+  EECON1bits.WR = 1;
+  INTCONbits.GIE = gie;
+  EECON1bits.WREN = 0;
+}
+
+
+// byte n of the EEPROM image of the current table
+static unsigned char EE_Image_Byte(unsigned int n)
+{
+  if (n == 0) { return PARAM_EE_MAGIC; }
+  if (n == 1) { return NUM_PARAMS; }
+  n = n - 2;
+  if (n & 1) { return (unsigned char)params[n >> 1]; }
+  return (unsigned char)(params[n >> 1] >> 8);
+}
+
+
+static void Load_Defaults(void)
+{
+  unsigned char i;
+
+  for (i = 0; i < NUM_PARAMS; i++)
+  {
+    params[i] = param_defaults[i];
+  }
+}
+
+
+/*******************************************************************************
+* FUNCTION NAME: Param_Initialization
+* PURPOSE:       Loads the parameter table from EEPROM, falling back to the
+*                compiled-in defaults if nothing valid has been saved.  A table
+*                saved by older code with fewer parameters is still used; the
+*                new ones keep their defaults.
+* CALLED FROM:   user_routines.c, User_Initialization
+* ARGUMENTS:     none
+* RETURNS:       void
+*******************************************************************************/
+void Param_Initialization(void)
+{
+  unsigned char count, sum, i;
+  unsigned int n;
+
+  Load_Defaults();
+
+  if (EE_Read(PARAM_EE_BASE) != PARAM_EE_MAGIC)
+    return;
+  count = EE_Read(PARAM_EE_BASE + 1);
+  if (count == 0 || count > NUM_PARAMS)
+    return;
+
+  sum = 0;
+  for (n = 0; n < 2 * (unsigned int)count + 2; n++)
+  {
+    sum += EE_Read(PARAM_EE_BASE + n);
+  }
+  if (sum != EE_Read(PARAM_EE_BASE + n))
+    return;
+
+  for (i = 0; i < count; i++)
+  {
+    params[i] = (int)(((unsigned int)EE_Read(PARAM_EE_BASE + 2 + 2 * i) << 8) |
+                      EE_Read(PARAM_EE_BASE + 3 + 2 * i));
+  }
+}
+
+
+/*******************************************************************************
+* FUNCTION NAME: Param_Send_Frame
+* PURPOSE:       Sends one reply frame.  The whole frame goes out back to back
+*                so a printf from the slow loop can never land in the middle
+*                of it.
+* CALLED FROM:   this file, and anything else that reports to the host tools
+* ARGUMENTS:
+*     Argument       Type             IO   Description
+*     --------       ----             --   -----------
+*     cmd            unsigned char    I    frame type
+*     len            unsigned char    I    payload length, <= PARAM_MAX_PAYLOAD
+*     payload        unsigned char *  I    payload bytes
+* RETURNS:       void
+*******************************************************************************/
+void Param_Send_Frame(unsigned char cmd, unsigned char len, unsigned char *payload)
+{
+  unsigned char sum = cmd + len;
+  unsigned char i;
+
+  while (!TXSTAbits.TRMT);
+  TXREG = PARAM_REPLY_SYNC;
+  while (!TXSTAbits.TRMT);
+  TXREG = cmd;
+  while (!TXSTAbits.TRMT);
+  TXREG = len;
+  for (i = 0; i < len; i++)
+  {
+    sum += payload[i];
+    while (!TXSTAbits.TRMT);
+    TXREG = payload[i];
+  }
+  while (!TXSTAbits.TRMT);
+  TXREG = sum;
+}
+
+
+static void Reply_Value(unsigned char cmd, unsigned char id, int value)
+{
+  unsigned char payload[3];
+
+  payload[0] = id;
+  payload[1] = (unsigned char)(value >> 8);
+  payload[2] = (unsigned char)value;
+  Param_Send_Frame(cmd, 3, payload);
+}
+
+
+// the SET reply also says which telemetry tick was the last one without it
+static void Reply_Set(unsigned char id)
+{
+  unsigned char payload[5];
+  unsigned int tick = tlm_tick - 1;
+
+  payload[0] = id;
+  payload[1] = (unsigned char)(params[id] >> 8);
+  payload[2] = (unsigned char)params[id];
+  payload[3] = (unsigned char)(tick >> 8);
+  payload[4] = (unsigned char)tick;
+  Param_Send_Frame(PARAM_CMD_SET, 5, payload);
+}
+
+
+// handles one complete request sitting in req_buf
+static void Handle_Request(void)
+{
+  unsigned char cmd = req_buf[1];
+  unsigned char id = req_buf[2];
+  int value = (int)(((unsigned int)req_buf[3] << 8) | req_buf[4]);
+
+  if ((unsigned char)(cmd + id + req_buf[3] + req_buf[4]) != req_buf[5])
+  {
+    Reply_Value(PARAM_CMD_ERROR, id, 0);
+    return;
+  }
+
+  // the commit writes the live table a byte at a time, so changing it now
+  // could save half of an old value and half of a new one
+  if (commit_pos != 0 && (cmd == PARAM_CMD_SET || cmd == PARAM_CMD_DEFAULTS))
+  {
+    Reply_Value(PARAM_CMD_BUSY, id, PARAM_EE_SIZE - (commit_pos - 1));
+    return;
+  }
+
+  switch (cmd) {
+  case PARAM_CMD_GET:
+  case PARAM_CMD_SET:
+    if (id >= NUM_PARAMS) {
+      Reply_Value(PARAM_CMD_ERROR, id, 0);
+      break;
+    }
+    if (cmd == PARAM_CMD_SET) {
+      params[id] = value;
+      Reply_Set(id);
+      break;
+    }
+    Reply_Value(cmd, id, params[id]);
+    break;
+  case PARAM_CMD_COUNT:
+    Reply_Value(cmd, 0, NUM_PARAMS);
+    break;
+  case PARAM_CMD_COMMIT:
+    if (commit_pos != 0) {     // already saving, the W reply is still to come
+      Reply_Value(PARAM_CMD_BUSY, 0, PARAM_EE_SIZE - (commit_pos - 1));
+      break;
+    }
+    commit_pos = 1;            // reply is sent when the last byte is written
+    commit_sum = 0;
+    break;
+  case PARAM_CMD_ESTOP:
+    drive_estop = (value != 0);
+    Reply_Value(cmd, 0, drive_estop);
+    break;
+  case PARAM_CMD_DEFAULTS:
+    Load_Defaults();
+    Reply_Value(cmd, 0, NUM_PARAMS);
+    break;
+  default:
+    Reply_Value(PARAM_CMD_ERROR, id, 0);
+    break;
+  }
+}
+
+
+// writes the next EEPROM byte of a running commit, if the last one is done
+static void Commit_Step(void)
+{
+  unsigned int n;
+  unsigned char data;
+
+  if (commit_pos == 0 || EECON1bits.WR)
+    return;
+
+  n = commit_pos - 1;
+  if (n < PARAM_EE_SIZE - 1) {
+    data = EE_Image_Byte(n);
+    commit_sum += data;
+  }
+  else {
+    data = commit_sum;
+  }
+
+  if (EE_Read(PARAM_EE_BASE + n) != data) {   // save EEPROM wear
+    EE_Start_Write(PARAM_EE_BASE + n, data);
+  }
+
+  if (n == PARAM_EE_SIZE - 1) {
+    commit_pos = 0;
+    Reply_Value(PARAM_CMD_COMMIT, 0, PARAM_EE_SIZE);
+  }
+  else {
+    commit_pos = commit_pos + 1;
+  }
+}
+
+
+/*******************************************************************************
+* FUNCTION NAME: Param_Service
+* PURPOSE:       Feeds any received bytes to the request parser and advances a
+*                running EEPROM commit.  Never blocks except to send a reply.
+* CALLED FROM:   user_routines_fast.c, Process_Data_From_Local_IO
+* ARGUMENTS:     none
+* RETURNS:       void
+*******************************************************************************/
+void Param_Service(void)
+{
+  unsigned char c;
+
+  if (RCSTAbits.OERR)      // overrun stops the receiver until it is reset
+  {
+    RCSTAbits.CREN = 0;
+    RCSTAbits.CREN = 1;
+    req_pos = 0;
+  }
+
+  while (PIR1bits.RCIF)
+  {
+    c = RCREG;
+    if (req_pos == 0 && c != PARAM_REQ_SYNC)
+      continue;            // resync on the next sync byte
+    req_buf[req_pos] = c;
+    req_pos = req_pos + 1;
+    if (req_pos == PARAM_REQ_LEN)
+    {
+      req_pos = 0;
+      Handle_Request();
+    }
+  }
+
+  Commit_Step();
+}
+/******************************************************************************/
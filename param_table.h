@@ -0,0 +1,111 @@
+/*******************************************************************************
+* FILE NAME: param_table.h
+*
+* DESCRIPTION:
+*  Tunable parameter table and the binary get/set protocol used to change it
+*  over the programming port without reflashing.  This header is shared by the
+*  robot code and the host tools in host/, so it must not pull in any of the
+*  ifi_*.h headers.
+*
+*  Host -> robot (6 bytes):
+*    PARAM_REQ_SYNC, cmd, id, value_hi, value_lo, checksum
+*  Robot -> host (len + 4 bytes):
+*    PARAM_REPLY_SYNC, cmd, len, payload[len], checksum
+*
+*  Checksums are the low byte of the sum of every byte after the sync byte.
+*  Values are 16 bit signed, big endian.  Replies to PARAM_CMD_* carry
+*  id, value_hi, value_lo as the payload.  The SET reply adds tick_hi,
+*  tick_lo: the tick of the latest telemetry snapshot (telemetry.h), so the
+*  first frame with a later tick is the first one that ran with the value.
+*
+*******************************************************************************/
+
+#ifndef __param_table_h_
+#define __param_table_h_
+
+/*
+ *  Every tunable value: X(name, default).  The order here is the id used on
+ *  the wire and the layout in EEPROM, so only ever append to the end.
+ *  Names ending in _PCT are fractions stored in hundredths (33 == 0.33).
+ *  ACCEL_* / DECEL_* are drive ramp limits per 17ms tick, 1024 == full
+ *  scale (see Drive_Profile in user_routines.c), 0 or more than 2048
+ *  turns the limit off.
+ */
+#define PARAM_LIST(X) \
+  X(HAND_OPEN,          200) \
+  X(HAND_CLOSED,          0) \
+  X(ARM_PERIOD,         250) \
+  X(LB_FOR_BOTTOM,      135) \
+  X(LB_FOR_TOP,         167) \
+  X(LB_REV_BOTTOM,      121) \
+  X(LB_REV_TOP,          99) \
+  X(RB_FOR_BOTTOM,      145) \
+  X(RB_FOR_TOP,         211) \
+  X(RB_REV_BOTTOM,      114) \
+  X(RB_REV_TOP,          45) \
+  X(LF_FOR_BOTTOM,      141) \
+  X(LF_FOR_TOP,         220) \
+  X(LF_REV_BOTTOM,      109) \
+  X(LF_REV_TOP,          45) \
+  X(RF_FOR_BOTTOM,      141) \
+  X(RF_FOR_TOP,         215) \
+  X(RF_REV_BOTTOM,      116) \
+  X(RF_REV_TOP,          45) \
+  X(L_LIGHT_MAX,        700) \
+  X(L_LIGHT_MIN,         80) \
+  X(R_LIGHT_MAX,       1050) \
+  X(R_LIGHT_MIN,        300) \
+  X(L_PROX_MAX,         500) \
+  X(L_PROX_MIN,           5) \
+  X(R_PROX_MAX,         500) \
+  X(R_PROX_MIN,           5) \
+  X(LIGHT_DARK,         960) \
+  X(LIGHT_TURN_PCT,      33) \
+  X(LIGHT_STOP_PROX,    170) \
+  X(LIGHT_HOLDOFF,      200) \
+  X(WALL_RIGHT_PCT,      30) \
+  X(WALL_LEFT_PCT,       35) \
+  X(WALL_AHEAD,          70) \
+  X(WALL_CLEAR,          50) \
+  X(LINE_STOP_PROX,     150) \
+  X(CLIMB_LOW,          150) \
+  X(CLIMB_HIGH,         400) \
+  X(CLIMB_EXIT,          15) \
+  X(CLIMB_COUNT,        250) \
+  X(LIMIT_THRESH,       500) \
+  X(ACCEL_JOY,           80) \
+  X(DECEL_JOY,          128) \
+  X(ACCEL_AUTO,          48) \
+  X(DECEL_AUTO,          96) \
+  X(ACCEL_CLIMB,         24) \
+  X(DECEL_CLIMB,         64)
+
+#define PARAM_ENUM(name, def)   P_##name,
+enum { PARAM_LIST(PARAM_ENUM) NUM_PARAMS };
+#undef PARAM_ENUM
+
+/* Fraction parameters (the _PCT ones) as a float. */
+#define PARAM_FRACTION(id)      ((float)params[id] * 0.01)
+
+#define PARAM_REQ_SYNC          0xA5
+#define PARAM_REPLY_SYNC        0x5A
+#define PARAM_REQ_LEN           6
+#define PARAM_MAX_PAYLOAD       32
+
+#define PARAM_CMD_GET           'G'   /* read one value */
+#define PARAM_CMD_SET           'S'   /* write one value to RAM */
+#define PARAM_CMD_COUNT         'N'   /* value = NUM_PARAMS */
+#define PARAM_CMD_COMMIT        'W'   /* save the table to EEPROM */
+#define PARAM_CMD_DEFAULTS      'D'   /* restore compiled-in defaults to RAM */
+#define PARAM_CMD_BUSY          'B'   /* commit running: W follows, S/D refused */
+#define PARAM_CMD_ESTOP         'X'   /* value != 0 cuts the drive, 0 releases */
+#define PARAM_CMD_ERROR         '?'   /* bad id, command or checksum */
+
+extern int params[NUM_PARAMS];
+extern unsigned char drive_estop;     /* in user_routines.c, see Default_Routine */
+
+void Param_Initialization(void);
+void Param_Service(void);
+void Param_Send_Frame(unsigned char cmd, unsigned char len, unsigned char *payload);
+
+#endif
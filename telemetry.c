@@ -0,0 +1,78 @@
+/*******************************************************************************
+* FILE NAME: telemetry.c
+*
+* DESCRIPTION:
+*  Builds the per-tick telemetry snapshot in Process_Data_From_Master_uP and
+*  sends it from the fast loop, so the 17ms handler only copies a few bytes
+*  instead of waiting on the serial port.  See telemetry.h for the layout.
+*
+* USAGE:
+*  Call Telemetry_Service() from Process_Data_From_Local_IO in
+*  user_routines_fast.c.  host/vextlm records and plots the frames.
+*
+*******************************************************************************/
+
+#include "ifi_aliases.h"
+#include "ifi_default.h"
+#include "ifi_utilities.h"
+#include "param_table.h"
+#include "telemetry.h"
+
+unsigned char tlm_buf[TLM_PAYLOAD_LEN];
+unsigned char tlm_pos = 0;
+unsigned char tlm_ready = 0;
+unsigned int tlm_tick = 0;
+
+
+// starts a new snapshot, dropping the last one if it was never sent
+void Telemetry_Begin(void)
+{
+  tlm_ready = 0;
+  tlm_pos = 0;
+  Telemetry_Put_Word(tlm_tick);
+  tlm_tick = tlm_tick + 1;
+}
+
+
+void Telemetry_Put_Word(int value)
+{
+  if (tlm_pos + 2 > TLM_PAYLOAD_LEN)
+    return;
+  tlm_buf[tlm_pos] = (unsigned char)(value >> 8);
+  tlm_buf[tlm_pos + 1] = (unsigned char)value;
+  tlm_pos = tlm_pos + 2;
+}
+
+
+void Telemetry_Put_Byte(unsigned char value)
+{
+  if (tlm_pos >= TLM_PAYLOAD_LEN)
+    return;
+  tlm_buf[tlm_pos] = value;
+  tlm_pos = tlm_pos + 1;
+}
+
+
+// marks the snapshot ready to send, only if every field was filled in
+void Telemetry_End(void)
+{
+  if (tlm_pos == TLM_PAYLOAD_LEN)
+    tlm_ready = 1;
+}
+
+
+/*******************************************************************************
+* FUNCTION NAME: Telemetry_Service
+* PURPOSE:       Sends the latest snapshot, if there is one waiting.
+* CALLED FROM:   user_routines_fast.c, Process_Data_From_Local_IO
+* ARGUMENTS:     none
+* RETURNS:       void
+*******************************************************************************/
+void Telemetry_Service(void)
+{
+  if (!tlm_ready)
+    return;
+  tlm_ready = 0;
+  Param_Send_Frame(TLM_FRAME_CMD, TLM_PAYLOAD_LEN, tlm_buf);
+}
+/******************************************************************************/
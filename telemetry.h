@@ -0,0 +1,58 @@
+/*******************************************************************************
+* FILE NAME: telemetry.h
+*
+* DESCRIPTION:
+*  Per-tick sensor and PWM snapshot sent to the host tools.  It goes out as
+*  a reply frame (see param_table.h) of type TLM_FRAME_CMD, so it shares the
+*  port with the parameter protocol.  Shared by the robot code and host/.
+*
+*  Payload, all words 16 bit big endian:
+*    tick, analog[TLM_ANALOG_COUNT], pwm02..pwm07, auto_mode, drive_state,
+*    drive_estop
+*
+*******************************************************************************/
+
+#ifndef __telemetry_h_
+#define __telemetry_h_
+
+#define TLM_FRAME_CMD           'T'
+
+/* Analog channels in payload order: X(name) */
+#define TLM_ANALOG_LIST(X) \
+  X(left_light) \
+  X(right_light) \
+  X(left_prox) \
+  X(middle_prox) \
+  X(right_prox) \
+  X(limit_lower) \
+  X(limit_upper) \
+  X(pixel)
+
+#define TLM_ANALOG_ENUM(name)   TLM_##name,
+enum { TLM_ANALOG_LIST(TLM_ANALOG_ENUM) TLM_ANALOG_COUNT };
+#undef TLM_ANALOG_ENUM
+
+#define TLM_PWM_FIRST           2     /* pwm02 */
+#define TLM_PWM_COUNT           6     /* pwm02..pwm07 */
+
+#define TLM_OFS_TICK            0
+#define TLM_OFS_ANALOG          2
+#define TLM_OFS_PWM             (TLM_OFS_ANALOG + 2 * TLM_ANALOG_COUNT)
+#define TLM_OFS_AUTO_MODE       (TLM_OFS_PWM + TLM_PWM_COUNT)
+#define TLM_OFS_DRIVE_STATE     (TLM_OFS_AUTO_MODE + 1)
+#define TLM_OFS_ESTOP           (TLM_OFS_DRIVE_STATE + 1)
+#define TLM_PAYLOAD_LEN         (TLM_OFS_ESTOP + 1)
+
+/* Line-scan camera (camera_code.c): 128 pixels then the exposure time, ASCII. */
+#define TLM_CAM_PIXELS          128
+#define TLM_CAM_VALUES          (TLM_CAM_PIXELS + 1)
+
+extern unsigned int tlm_tick;         /* tick the next snapshot will carry */
+
+void Telemetry_Begin(void);
+void Telemetry_Put_Word(int value);
+void Telemetry_Put_Byte(unsigned char value);
+void Telemetry_End(void);
+void Telemetry_Service(void);
+
+#endif
@@ -16,15 +16,18 @@
 #include "ifi_utilities.h"
 #include "user_routines.h"
 #include "printf_lib.h"
+#include "param_table.h"
+#include "telemetry.h"
 
 #define CODE_VERSION            10
 
 #define BUTTON_REV_THRESH       100
 #define BUTTON_FWD_THRESH       154
 #define NEUTRAL_VALUE           127
-#define open     200
-#define closed     0
-#define period     250
+#define ESTOP_ON_THRESH         30      // channel 4 held hard left: e-stop
+#define ESTOP_OFF_THRESH        225     // channel 4 held hard right: release
+#define ESTOP_HOLD              15      // ticks the stick must be held, ~0.25s
+#define PROFILE_ONE             1024    // 1.0 in the drive profile's fixed point
 
 float Left_Side = 0.0;  // -1.0 to 1.0
 float Right_Side = 0.0;  // -1.0 to 1.0 
@@ -40,6 +43,10 @@ unsigned int arm_count = 0;
 unsigned int light_count = 0;
 int arm_pwm = 127;
 int hand_pwm = 0;
+int left_profile = 0;   // drive output actually sent, PROFILE_ONE = 1.0
+int right_profile = 0;
+unsigned char drive_estop = 0;   // set: Drive_Profile holds the drive at 0
+unsigned int estop_count = 0;
 
 
 // PURPOSE:       Limits the mixed value for one joystick drive.
@@ -162,6 +169,7 @@ void User_Initialization (void)
 /* Add any other user initialization code here. */
 
   Initialize_Serial_Comms();     
+  Param_Initialization();        /* Tunables from EEPROM, see param_table.h */
  
   Putdata(&txdata);             /* DO NOT CHANGE! */
   User_Proc_Is_Ready();         /* DO NOT CHANGE! - last line of User_Initialization */
@@ -183,10 +191,10 @@ void User_Initialization (void)
 unsigned char Set_LB_Motor(float motor_val)
 {
   // operational range
-  int for_bottom = 135;
-  int for_top = 167;
-  int rev_bottom = 121;
-  int rev_top = 99;
+  int for_bottom = params[P_LB_FOR_BOTTOM];
+  int for_top = params[P_LB_FOR_TOP];
+  int rev_bottom = params[P_LB_REV_BOTTOM];
+  int rev_top = params[P_LB_REV_TOP];
   int pwm = 0;
   
   motor_val = motor_val / divisor;
@@ -214,10 +222,10 @@ unsigned char Set_LB_Motor(float motor_val)
 unsigned char Set_RB_Motor(float motor_val)
 {
   // operational range
-  int for_bottom = 145;
-  int for_top = 211;
-  int rev_bottom = 114;
-  int rev_top = 45;
+  int for_bottom = params[P_RB_FOR_BOTTOM];
+  int for_top = params[P_RB_FOR_TOP];
+  int rev_bottom = params[P_RB_REV_BOTTOM];
+  int rev_top = params[P_RB_REV_TOP];
   int pwm = 0;
   
   motor_val = motor_val / divisor;
@@ -246,10 +254,10 @@ unsigned char Set_RB_Motor(float motor_val)
 unsigned char Set_LF_Motor(float motor_val)
 {
   // operational range
-  int for_bottom = 141;
-  int for_top = 220;
-  int rev_bottom = 109;
-  int rev_top = 45;
+  int for_bottom = params[P_LF_FOR_BOTTOM];
+  int for_top = params[P_LF_FOR_TOP];
+  int rev_bottom = params[P_LF_REV_BOTTOM];
+  int rev_top = params[P_LF_REV_TOP];
   int pwm = 0;
   
   motor_val = motor_val / divisor;
@@ -278,10 +286,10 @@ unsigned char Set_LF_Motor(float motor_val)
 unsigned char Set_RF_Motor(float motor_val)
 {
   // operational range
-  int for_bottom = 141;
-  int for_top = 215;
-  int rev_bottom = 116;
-  int rev_top = 45;
+  int for_bottom = params[P_RF_FOR_BOTTOM];
+  int for_top = params[P_RF_FOR_TOP];
+  int rev_bottom = params[P_RF_REV_BOTTOM];
+  int rev_top = params[P_RF_REV_TOP];
   int pwm = 0;
   
   motor_val = motor_val / divisor;
@@ -310,8 +318,8 @@ unsigned char Set_RF_Motor(float motor_val)
 float Set_L_Light_Sensor(int left_eye)
 {
   // operational range
-  int maxL = 700;   // ~ dark
-  int minL = 80;   // ~ 1ft away
+  int maxL = params[P_L_LIGHT_MAX];   // ~ dark
+  int minL = params[P_L_LIGHT_MIN];   // ~ 1ft away
   float val = 0;
   
   val = ((float)(left_eye - minL)) / ((float)(maxL - minL));
@@ -322,8 +330,8 @@ float Set_L_Light_Sensor(int left_eye)
 float Set_R_Light_Sensor(int right_eye)
 {
   // operational range
-  int maxR = 1050;   // ~ dark
-  int minR = 300;   // ~ 1ft away
+  int maxR = params[P_R_LIGHT_MAX];   // ~ dark
+  int minR = params[P_R_LIGHT_MIN];   // ~ 1ft away
   float val = 0;
   
   val = ((float)(right_eye - minR)) / ((float)(maxR - minR));
@@ -336,8 +344,8 @@ float Set_R_Light_Sensor(int right_eye)
 float Set_L_Prox(int left_prox)
 {
   // operational range
-  int maxL = 500;   // ~ 2 inches away
-  int minL = 5;   // ~ infinite away
+  int maxL = params[P_L_PROX_MAX];   // ~ 2 inches away
+  int minL = params[P_L_PROX_MIN];   // ~ infinite away
   float val = 0;
   
   val = ((float)(left_prox - minL)) / ((float)(maxL - minL));
@@ -348,8 +356,8 @@ float Set_L_Prox(int left_prox)
 float Set_R_Prox(int right_prox)
 {
   // operational range
-  int maxR = 500;   // ~ 2 inches away
-  int minR = 5;   // ~ infinite away
+  int maxR = params[P_R_PROX_MAX];   // ~ 2 inches away
+  int minR = params[P_R_PROX_MIN];   // ~ infinite away
   float val = 0;
   
   val = ((float)(right_prox - minR)) / ((float)(maxR - minR));
@@ -404,6 +412,89 @@ void Process_Driving_State(int drive_state)
 
  
 
+// pulses SI and clocks the line-scan camera through all 128 pixels, then
+// reads the analog output
+int Read_Camera_Pixel(void)
+{
+  int SI_out;
+  int i;
+
+  SI_out = 1;
+  rc_dig_out16 = SI_out;
+  SI_out = 0;
+  rc_dig_out16 = SI_out;
+  for(i = 0; i < 128; i++) {
+    rc_dig_out14 = 1;
+    rc_dig_out14 = 0;
+  }
+  return (int)Get_Analog_Value(rc_ana_in08);
+}
+
+
+// moves current toward target by at most accel per tick while speeding up and
+// decel per tick while slowing down, which gives a trapezoidal speed profile.
+// A reversal always slows to zero first.  A limit of 0 or less, or more than
+// a full swing, means no limit; clamping it here also keeps the 16 bit sums
+// below from overflowing.
+int Slew_Limit(int current, int target, int accel, int decel)
+{
+  if (accel <= 0 || accel > 2 * PROFILE_ONE) { accel = 2 * PROFILE_ONE; }
+  if (decel <= 0 || decel > 2 * PROFILE_ONE) { decel = 2 * PROFILE_ONE; }
+
+  if (current > 0 && target < current) {         // slowing down forwards
+    current = current - decel;
+    if (current < target) { current = target; }
+    if (target < 0 && current < 0) { current = 0; }
+  }
+  else if (current < 0 && target > current) {    // slowing down in reverse
+    current = current + decel;
+    if (current > target) { current = target; }
+    if (target > 0 && current > 0) { current = 0; }
+  }
+  else if (target > current) {                   // speeding up forwards
+    current = current + accel;
+    if (current > target) { current = target; }
+  }
+  else if (target < current) {                   // speeding up in reverse
+    current = current - accel;
+    if (current < target) { current = target; }
+  }
+  return current;
+}
+
+
+// runs Left_Side / Right_Side through the slew limiter for the current mode,
+// or cuts the drive to zero at once while an emergency stop is on
+void Drive_Profile(int estop)
+{
+  int accel, decel;
+  int left_target = (int)(Left_Side * PROFILE_ONE);
+  int right_target = (int)(Right_Side * PROFILE_ONE);
+
+  if (estop) {
+    left_profile = 0;
+    right_profile = 0;
+    return;
+  }
+
+  if (auto_mode == 0) {          // joystick
+    accel = params[P_ACCEL_JOY];
+    decel = params[P_DECEL_JOY];
+  }
+  else if (auto_mode == 5) {     // wall climber
+    accel = params[P_ACCEL_CLIMB];
+    decel = params[P_DECEL_CLIMB];
+  }
+  else {
+    accel = params[P_ACCEL_AUTO];
+    decel = params[P_DECEL_AUTO];
+  }
+
+  left_profile = Slew_Limit(left_profile, left_target, accel, decel);
+  right_profile = Slew_Limit(right_profile, right_target, accel, decel);
+}
+
+
 /*******************************************************************************
 * FUNCTION NAME: Process_Data_From_Master_uP
 * PURPOSE:       Executes every 17ms when it gets new data from the master 
@@ -418,7 +509,8 @@ void Process_Data_From_Master_uP(void)
   int left_prox, middle_prox, right_prox;
   int limit_lower, limit_upper;
   float diff_light, diff_prox;
-  int SI_out, pixel_out, pixel_in;
+  int pixel_in;
+  float left_out, right_out;
   
   Getdata(&rxdata);   /* Get fresh data from the master microprocessor. */
 
@@ -440,16 +532,7 @@ void Process_Data_From_Master_uP(void)
   
   
   // run camera code every iteration??
-  SI_out = 1;
-  rc_dig_out16 = SI_out;
-  SI_out = 0;
-  rc_dig_out16 = SI_out;
-  for(int i = 0; i < 128; i++) {
-    rc_dig_out14 = 1;
-    rc_dig_out14 = 0;
-  }
-  pixel_in = (int)Get_Analog_Value(rc_ana_in08);
-  println("Camera Value: %d", pixel_in);
+  pixel_in = Read_Camera_Pixel();
   
   
   if(counter > 0) {    // persistent turn mode 
@@ -469,14 +552,14 @@ void Process_Data_From_Master_uP(void)
     case 1:      // light source following
       if (light_count > 0) { light_count = light_count - 1; }
       
-      if (left_light > 960 && right_light > 960) {
+      if (left_light > params[P_LIGHT_DARK] && right_light > params[P_LIGHT_DARK]) {
         // spinning search mode
         drive_state = 4;               /////////// check on race day ///////////
       }
-      else if (diff_light > 0.33) {  // right
+      else if (diff_light > PARAM_FRACTION(P_LIGHT_TURN_PCT)) {  // right
         drive_state = 3;
       }
-      else if (diff_light < -0.33) {  // left
+      else if (diff_light < -PARAM_FRACTION(P_LIGHT_TURN_PCT)) {  // left
         drive_state = 4;
       }
       else {      // straight
@@ -484,9 +567,9 @@ void Process_Data_From_Master_uP(void)
       }
 
       // end condition
-      if (middle_prox > 170 && light_count == 0) {
+      if (middle_prox > params[P_LIGHT_STOP_PROX] && light_count == 0) {
         drive_state = 0;
-        arm_count = period;
+        arm_count = params[P_ARM_PERIOD];
         auto_mode = 4;
       }
       
@@ -494,17 +577,17 @@ void Process_Data_From_Master_uP(void)
       break;
       
     case 2:    // avoid walls mode
-      if (diff_prox > 0.3) {  // right
+      if (diff_prox > PARAM_FRACTION(P_WALL_RIGHT_PCT)) {  // right
         drive_state = 3;
       }
-      else if (diff_prox < -0.35) {  // left
+      else if (diff_prox < -PARAM_FRACTION(P_WALL_LEFT_PCT)) {  // left
         drive_state = 4;
       }
       else {     // straight
         drive_state = 1;
       }
       
-      if (middle_prox > 70) {
+      if (middle_prox > params[P_WALL_AHEAD]) {
         if (diff_prox > 0.0) {
           drive_state = 3; 
         }      // right
@@ -513,9 +596,9 @@ void Process_Data_From_Master_uP(void)
         }       // left
       }
       
-      if (left_prox < 50 && right_prox < 50) {   // end condition
+      if (left_prox < params[P_WALL_CLEAR] && right_prox < params[P_WALL_CLEAR]) {   // end condition
         auto_mode = 1; 
-        light_count = 200;
+        light_count = params[P_LIGHT_HOLDOFF];
       }
       
       Process_Driving_State(drive_state);
@@ -525,7 +608,7 @@ void Process_Data_From_Master_uP(void)
       // 
       drive_state = 0;
       
-      if (middle_prox > 150) {  // end condition
+      if (middle_prox > params[P_LINE_STOP_PROX]) {  // end condition
         drive_state = 0;
         auto_mode = 5;
       }  // enter wall climb mode
@@ -535,16 +618,16 @@ void Process_Data_From_Master_uP(void)
           
     case 4:      // lower arm, counter, hand closed      
       if (arm_count > 0) {
-        hand_pwm = closed;
+        hand_pwm = params[P_HAND_CLOSED];
         arm_pwm = 0;
         arm_count = arm_count - 1;
       } else { 
-        hand_pwm = open;
+        hand_pwm = params[P_HAND_OPEN];
         arm_pwm = 127;
         auto_mode = 0; 
       }
       
-      if (limit_lower < 500) {
+      if (limit_lower < params[P_LIMIT_THRESH]) {
         arm_count = 0;
       }
       drive_state = 0;
@@ -552,16 +635,16 @@ void Process_Data_From_Master_uP(void)
       break;
       
     case 5:     // wall climber,assume front first
-      if (middle_prox < 150) {
+      if (middle_prox < params[P_CLIMB_LOW]) {
         drive_state = 1;     //post wall
-        if (left_prox > 15 || right_prox > 15)
+        if (left_prox > params[P_CLIMB_EXIT] || right_prox > params[P_CLIMB_EXIT])
         { auto_mode = 2; }     // end condition
       }
-      else if (middle_prox > 150 && middle_prox < 400)
+      else if (middle_prox > params[P_CLIMB_LOW] && middle_prox < params[P_CLIMB_HIGH])
       { drive_state = 7; }
-      else if (middle_prox > 400) {
+      else if (middle_prox > params[P_CLIMB_HIGH]) {
         drive_state = 8;    // full speed over
-        counter = 250;
+        counter = params[P_CLIMB_COUNT];
       } // maybe use back_prox instead
       
       Process_Driving_State(drive_state);
@@ -582,9 +665,9 @@ void Process_Data_From_Master_uP(void)
   { slow_mode = 1; }
   divisor = 4.0 * ((float)(slow_mode + 1));
 
-  if (limit_lower < 500 && arm_pwm < 127)   // stop arm
+  if (limit_lower < params[P_LIMIT_THRESH] && arm_pwm < 127)   // stop arm
   { arm_pwm = 127; }
-  if (limit_upper > 500 && arm_pwm > 127)
+  if (limit_upper > params[P_LIMIT_THRESH] && arm_pwm > 127)
   { arm_pwm = 127; }
 
 //  printf("Chute: Left = %d, Middle = %d, Right = %d\n", 
@@ -595,15 +678,41 @@ void Process_Data_From_Master_uP(void)
 
 
 
+  // ramp the drive, normal stops included; only an e-stop skips the ramp
+  Drive_Profile(drive_estop);
+  left_out = ((float)left_profile) / PROFILE_ONE;
+  right_out = ((float)right_profile) / PROFILE_ONE;
+
   // four wheel drive        // 3,4,5,6 reverse
-  pwm06 = Set_LB_Motor(Left_Side);
-  pwm05 = Set_RB_Motor(Right_Side);
-  pwm04 = Set_LF_Motor(Left_Side);
-  pwm03 = Set_RF_Motor(Right_Side);
+  pwm06 = Set_LB_Motor(left_out);
+  pwm05 = Set_RB_Motor(right_out);
+  pwm04 = Set_LF_Motor(left_out);
+  pwm03 = Set_RF_Motor(right_out);
     
   // arm and hand control
   pwm02 = arm_pwm;
   pwm07 = hand_pwm;
+
+  // snapshot for host/vextlm, sent from the fast loop (telemetry.h)
+  Telemetry_Begin();
+  Telemetry_Put_Word(left_light);
+  Telemetry_Put_Word(right_light);
+  Telemetry_Put_Word(left_prox);
+  Telemetry_Put_Word(middle_prox);
+  Telemetry_Put_Word(right_prox);
+  Telemetry_Put_Word(limit_lower);
+  Telemetry_Put_Word(limit_upper);
+  Telemetry_Put_Word(pixel_in);
+  Telemetry_Put_Byte(pwm02);
+  Telemetry_Put_Byte(pwm03);
+  Telemetry_Put_Byte(pwm04);
+  Telemetry_Put_Byte(pwm05);
+  Telemetry_Put_Byte(pwm06);
+  Telemetry_Put_Byte(pwm07);
+  Telemetry_Put_Byte((unsigned char)auto_mode);
+  Telemetry_Put_Byte((unsigned char)drive_state);
+  Telemetry_Put_Byte(drive_estop);
+  Telemetry_End();
  
   Putdata(&txdata);             /* DO NOT CHANGE! */
 }
@@ -664,7 +773,7 @@ void Default_Routine(void)
       if (auto_mode == 0) { auto_mode = 5; }
       else { auto_mode = auto_mode - 1; }
        
-      if (auto_mode == 4) { arm_count = period; }
+      if (auto_mode == 4) { arm_count = params[P_ARM_PERIOD]; }
       if (auto_mode == 1) { light_count = 0; }
     }
   } else if (PWM_in5 > BUTTON_FWD_THRESH) {
@@ -673,7 +782,7 @@ void Default_Routine(void)
       if (auto_mode == 5) { auto_mode = 0; }
       else { auto_mode = auto_mode + 1; }
        
-      if (auto_mode == 4) { arm_count = period; }
+      if (auto_mode == 4) { arm_count = params[P_ARM_PERIOD]; }
       if (auto_mode == 1) { light_count = 0; }
     }
   } else { 
@@ -685,16 +794,28 @@ void Default_Routine(void)
   if (PWM_in6 < BUTTON_REV_THRESH) {
     btn_count2 = btn_count2 + 1;
  if (btn_count2 == 5) {
-      hand_pwm = open;
+      hand_pwm = params[P_HAND_OPEN];
     }
   } else if (PWM_in6 > BUTTON_FWD_THRESH) {
     btn_count2 = btn_count2 + 1;
     if (btn_count2 == 5) {
-      hand_pwm = closed;
+      hand_pwm = params[P_HAND_CLOSED];
     }
   } else {
     btn_count2 = 0;
   }
+
+  // Channel 4 (left stick sideways) is the e-stop, so it works with no
+  // tether: held hard left it latches, held hard right it releases.
+  // vexparam estop / release set the same flag over the serial port.
+  if (PWM_in4 < ESTOP_ON_THRESH || PWM_in4 > ESTOP_OFF_THRESH) {
+    if (estop_count < ESTOP_HOLD) {
+      estop_count = estop_count + 1;
+      if (estop_count == ESTOP_HOLD) { drive_estop = (PWM_in4 < ESTOP_ON_THRESH); }
+    }
+  } else {
+    estop_count = 0;
+  }
   
 }
 /******************************************************************************/